@@ -0,0 +1,1044 @@
+#ifndef GPHYSICS_BENCH
+# define GPHYSICS_BENCH
+
+//* Headless physics benchmarks -> `make bench && ./build/physics_bench`
+
+#include <blblstd.hpp>
+#include <math.cpp>
+#include <time.cpp>
+#include <physics_2d.cpp>
+#include <physics_snapshot.cpp>
+#include <tilemap_terrain.cpp>
+#include <physics_scene.cpp>
+
+namespace Bench {
+	using namespace Physics2D;
+
+	//* xorshift, deterministic scenes between runs
+	struct Rng {
+		u64 state = 0x9E3779B97F4A7C15;
+
+		u64 next() {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return state;
+		}
+
+		f32 unit() { return f32(next() >> 40) / f32(1 << 24); }
+		f32 range(f32 min, f32 max) { return lerp(min, max, unit()); }
+		v2f32 point(rtf32 area) { return v2f32(range(area.min.x, area.max.x), range(area.min.y, area.max.y)); }
+	};
+
+	struct Stopwatch {
+		Time::moment start = Time::now();
+		f64 ms() const { return Time::duration_cast<Time::t64>(Time::now() - start).count() * 1000.0; }
+	};
+
+	//* square area scaled so the collider density stays the same whatever the count
+	rtf32 spawn_area(u32 count, f32 density) {
+		auto side = glm::sqrt(f32(count) / density);
+		return { v2f32(-side / 2), v2f32(+side / 2) };
+	}
+
+	Array<Collider> random_colliders(Arena& arena, Rng& rng, u32 count, const Convex& shape, f32 density = 0.25f) {
+		auto area = spawn_area(count, density);
+		auto colliders = arena.push_array<Collider>(count);
+		for (auto i : u32xrange{ 0, count }) {
+			m3x3f32 transform = Transform2D{ .translation = rng.point(area), .scale = v2f32(1), .rotation = rng.range(0, 360) };
+			colliders[i] = {
+				.transform = transform,
+				.aabb = aabb_convex(shape, transform),
+				.shape = &shape,
+				.body_id = i32(i),
+				.layers = 1
+			};
+		}
+		return colliders;
+	}
+
+	Convex regular_polygon(Arena& arena, u32 sides, f32 radius = 0.5f) {
+		auto vertices = arena.push_array<v2f32>(sides);
+		for (auto i : u32xrange{ 0, sides }) {
+			auto angle = glm::two_pi<f32>() * f32(i) / f32(sides);
+			vertices[i] = v2f32(glm::cos(angle), glm::sin(angle)) * radius;
+		}
+		return Convex::make(vertices, 0);
+	}
+
+	void jitter(Rng& rng, Array<Collider> colliders, f32 amplitude) {
+		for (auto& col : colliders) {
+			auto offset = v2f32(rng.range(-amplitude, amplitude), rng.range(-amplitude, amplitude));
+			col.transform[2] += v3f32(offset, 0);
+			col.aabb = { col.aabb.min + offset, col.aabb.max + offset };
+		}
+	}
+
+	SimStep make_step(Arena& arena, Array<const Collider> colliders, SimStep::Layout layout = SimStep::AOS) {
+		auto step = SimStep::create(&arena, 1.f / 60.f, colliders.size(), colliders.size(), 256, layout);
+		for (auto& col : colliders)
+			step.push_collider(col);
+		return step;
+	}
+
+	void broadphase(Arena& arena, u32 count, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto rng = Rng{};
+		auto colliders = random_colliders(scratch, rng, count, Convex::UNIT_CIRCLE());
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+
+		f64 naive_ms = 0;
+		u64 naive_pairs = 0;
+		for (auto t : u32xrange{ 0, ticks }) {
+			(void)t;
+			step_arena.reset();
+			auto step = make_step(step_arena, colliders);
+			auto timer = Stopwatch{};
+			naive_pairs = broadphase_naive(step, detections).size();
+			naive_ms += timer.ms();
+		}
+
+		auto tree_arena = Arena::from_vmem(1ull << 30, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ tree_arena.vmem_release(); };
+		auto tree = TreeBroadphase::create(&tree_arena, count);
+		f64 build_ms = 0;
+		f64 tree_ms = 0;
+		u64 tree_pairs = 0;
+		for (auto t : u32xrange{ 0, ticks + 1 }) {
+			step_arena.reset();
+			if (t > 0)
+				jitter(rng, colliders, 0.05f);
+			auto step = make_step(step_arena, colliders);
+			auto timer = Stopwatch{};
+			tree_pairs = broadphase_tree(step, tree, detections).size();
+			(t == 0 ? build_ms : tree_ms) += timer.ms();
+			if (t == 0 && tree_pairs != naive_pairs)
+				fprintf(stderr, "broadphase mismatch : naive %llu pairs, tree %llu pairs\n", naive_pairs, tree_pairs);
+		}
+
+		auto sap = SAPBroadphase::create(&tree_arena, count);
+		f64 sap_build_ms = 0;
+		f64 sap_ms = 0;
+		u64 sap_swaps = 0;
+		for (auto t : u32xrange{ 0, ticks + 1 }) {
+			step_arena.reset();
+			if (t > 0)
+				jitter(rng, colliders, 0.05f);
+			auto step = make_step(step_arena, colliders);
+			auto timer = Stopwatch{};
+			broadphase_sap(step, sap, detections);
+			(t == 0 ? sap_build_ms : sap_ms) += timer.ms();
+			if (t > 0)
+				sap_swaps += sap.swaps;
+		}
+
+		printf("broadphase %6u colliders | naive %10.3f ms/tick | tree build %8.3f ms, update %8.3f ms/tick, height %3i | sap build %8.3f ms, update %8.3f ms/tick, %llu swaps/tick | %llu pairs\n",
+			count, naive_ms / ticks, build_ms, tree_ms / ticks, tree.tree.height(), sap_build_ms, sap_ms / ticks, sap_swaps / ticks, tree_pairs
+		);
+	}
+
+	//* same scene & jitter through every broadphase with each collider layout, only the step's storage differs
+	void collider_layout(Arena& arena, u32 count, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto step_arena = Arena::from_vmem(1ull << 26, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto broadphase_arena = Arena::from_vmem(1ull << 30, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ broadphase_arena.vmem_release(); };
+
+		u64 pairs[2][Broadphase::SAP + 1] = {};
+		f64 ms[2][Broadphase::SAP + 1] = {};
+		for (auto layout : { SimStep::AOS, SimStep::SOA }) for (auto mode : { Broadphase::NAIVE, Broadphase::TREE, Broadphase::SAP }) {
+			broadphase_arena.reset();
+			auto broadphase = Broadphase::create(&broadphase_arena, mode, count);
+			auto rng = Rng{};
+			auto colliders = random_colliders(scratch, rng, count, Convex::UNIT_CIRCLE());
+			auto mode_ticks = mode == Broadphase::NAIVE ? min(ticks, 2u) : ticks;//* quadratic, a couple ticks is plenty
+			for (auto t : u32xrange{ 0, mode_ticks + 1 }) {//* tick 0 builds the persistent structures
+				step_arena.reset();
+				if (t > 0)
+					jitter(rng, colliders, 0.05f);
+				auto step = make_step(step_arena, colliders, layout);
+				auto timer = Stopwatch{};
+				pairs[layout][mode] = broadphase(step, detections).size();
+				if (t > 0)
+					ms[layout][mode] += timer.ms() / mode_ticks;
+			}
+		}
+		for (auto mode : { Broadphase::NAIVE, Broadphase::TREE, Broadphase::SAP }) if (pairs[SimStep::AOS][mode] != pairs[SimStep::SOA][mode])
+			fprintf(stderr, "collider layout mismatch with %s : aos %llu pairs, soa %llu pairs\n", Broadphase::modes[mode], pairs[SimStep::AOS][mode], pairs[SimStep::SOA][mode]);
+
+		printf("collider layout %6u colliders | naive aos %10.3f soa %10.3f ms/tick | tree aos %8.3f soa %8.3f ms/tick | sap aos %8.3f soa %8.3f ms/tick | %llu pairs\n",
+			count,
+			ms[SimStep::AOS][Broadphase::NAIVE], ms[SimStep::SOA][Broadphase::NAIVE],
+			ms[SimStep::AOS][Broadphase::TREE], ms[SimStep::SOA][Broadphase::TREE],
+			ms[SimStep::AOS][Broadphase::SAP], ms[SimStep::SOA][Broadphase::SAP],
+			pairs[SimStep::AOS][Broadphase::TREE]
+		);
+	}
+
+	void narrowphase(Arena& arena, u32 count, u32 sides, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto rng = Rng{};
+		auto shape = regular_polygon(scratch, sides);
+		auto colliders = random_colliders(scratch, rng, count, shape, 1.f);
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+
+		f64 cached_ms = 0;
+		f64 uncached_ms = 0;
+		u64 tests = 0;
+		u64 manifolds = 0;
+		for (auto t : u32xrange{ 0, ticks }) {
+			(void)t;
+			step_arena.reset();
+			auto step = make_step(step_arena, colliders);
+			tests = broadphase_naive(step, detections).size();
+			{
+				auto timer = Stopwatch{};
+				manifolds = query_collisions(step_arena, step.tests.used(), step.colliders.used()).size();
+				cached_ms += timer.ms();
+			}
+			for (auto& col : step.colliders.used())
+				col.world_cloud = {};
+			{
+				auto timer = Stopwatch{};
+				query_collisions(step_arena, step.tests.used(), step.colliders.used());
+				uncached_ms += timer.ms();
+			}
+		}
+
+		printf("narrowphase %5u colliders, %2u sided polygons | world vertices cache %8.3f ms/tick | per query transform %8.3f ms/tick | %llu tests, %llu manifolds\n",
+			count, sides, cached_ms / ticks, uncached_ms / ticks, tests, manifolds
+		);
+	}
+
+	//* every other collider gets the second shape, fast paths against GJK/EPA on the same tests
+	void shape_pairs(Arena& arena, u32 count, const Convex& shape_a, const Convex& shape_b, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto rng = Rng{};
+		auto colliders = random_colliders(scratch, rng, count, shape_a, 1.f);
+		for (auto i : u32xrange{ 0, count }) if (i % 2) {
+			colliders[i].shape = &shape_b;
+			colliders[i].aabb = aabb_convex(shape_b, colliders[i].transform);
+		}
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+
+		f64 fast_ms = 0;
+		f64 gjk_ms = 0;
+		u64 manifolds[2] = { 0, 0 };
+		f32 max_deviation = 0;
+		for (auto t : u32xrange{ 0, ticks }) {
+			(void)t;
+			step_arena.reset();
+			auto step = make_step(step_arena, colliders);
+			broadphase_naive(step, detections);
+			Array<Manifold> results[2];
+			{
+				auto timer = Stopwatch{};
+				results[0] = query_collisions(step_arena, step.tests.used(), step.colliders.used(), { .fast_paths = true });
+				fast_ms += timer.ms();
+			}
+			{
+				auto timer = Stopwatch{};
+				results[1] = query_collisions(step_arena, step.tests.used(), step.colliders.used(), { .fast_paths = false });
+				gjk_ms += timer.ms();
+			}
+			manifolds[0] = results[0].size();
+			manifolds[1] = results[1].size();
+			//* EPA stops at its precision threshold, measure how far it lands from the closed forms
+			for (u64 i = 0, j = 0; i < results[0].size() && j < results[1].size();) {
+				auto& a = results[0][i].src;
+				auto& b = results[1][j].src;
+				if (a.ids[0] == b.ids[0] && a.ids[1] == b.ids[1]) {
+					max_deviation = max(max_deviation, glm::length(results[0][i].ctc.penetration - results[1][j].ctc.penetration));
+					i++, j++;
+				} else if (a.ids[0] < b.ids[0] || (a.ids[0] == b.ids[0] && a.ids[1] < b.ids[1])) {
+					i++;
+				} else {
+					j++;
+				}
+			}
+		}
+
+		printf("shape pairs %5u colliders, %-7s vs %-7s | fast paths %8.3f ms/tick, %llu manifolds | gjk/epa %8.3f ms/tick, %llu manifolds | max penetration deviation %.4f\n",
+			count, Convex::types[shape_a.type], Convex::types[shape_b.type], fast_ms / ticks, manifolds[0], gjk_ms / ticks, manifolds[1], max_deviation
+		);
+	}
+
+	//* polygons always go through GJK, colliders drift a little every tick like a coherent scene would
+	void gjk_warm_start(Arena& arena, u32 count, u32 sides, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto rng = Rng{};
+		auto shape = regular_polygon(scratch, sides);
+		auto colliders = random_colliders(scratch, rng, count, shape, 1.f);
+		for (auto i : u32xrange{ 0, count })
+			colliders[i].uid = collider_uid(1, i);
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto cache_arena = Arena::from_vmem(1ull << 26, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ cache_arena.vmem_release(); };
+		auto cache = GJKCache::create(&cache_arena, count * 4);
+
+		f64 cold_ms = 0;
+		f64 warm_ms = 0;
+		GJKCache::Stats cold = {};
+		GJKCache::Stats warm = {};
+		for (auto t : u32xrange{ 0, ticks + 1 }) {
+			step_arena.reset();
+			if (t > 0)
+				jitter(rng, colliders, 0.01f);
+			auto step = make_step(step_arena, colliders);
+			broadphase_naive(step, detections);
+			{
+				auto timer = Stopwatch{};
+				for (auto& test : step.tests.used()) {
+					u32 iterations = 0;
+					intersect_convex(support_function_of(step.colliders[test.ids[0]]), support_function_of(step.colliders[test.ids[1]]), 0.f, null, &iterations);
+					cold.queries++;
+					cold.iterations += iterations;
+				}
+				if (t > 0) cold_ms += timer.ms();
+			}
+			cache.next_tick();
+			{
+				auto timer = Stopwatch{};
+				query_collisions(step_arena, step.tests.used(), step.colliders.used(), { .fast_paths = false, .gjk = &cache });
+				if (t > 0) warm_ms += timer.ms();
+			}
+			if (t > 0) {//* first tick only fills the cache
+				warm.queries += cache.stats.queries;
+				warm.warm_hits += cache.stats.warm_hits;
+				warm.iterations += cache.stats.iterations;
+			}
+		}
+
+		printf("gjk warm start %5u colliders, %2u sided polygons | cold %8.3f ms/tick, %.2f iterations/query | warm %8.3f ms/tick, %.2f iterations/query, %.1f%% replayed\n",
+			count, sides,
+			cold_ms / ticks, f64(cold.iterations) / f64(max<u64>(1, cold.queries)),
+			warm_ms / ticks, f64(warm.iterations) / f64(max<u64>(1, warm.queries)), 100.0 * f64(warm.warm_hits) / f64(max<u64>(1, warm.queries))
+		);
+	}
+
+	//* resting scene where only a fraction of the colliders move, the rest should come straight from the contact cache
+	void contact_reuse(Arena& arena, u32 count, f32 moving_ratio, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto rng = Rng{};
+		auto shape = regular_polygon(scratch, 8);
+		auto colliders = random_colliders(scratch, rng, count, shape, 1.f);
+		for (auto i : u32xrange{ 0, count })
+			colliders[i].uid = collider_uid(1, i);
+		auto moving = colliders.subspan(0, u32(f32(count) * moving_ratio));
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto cache_arena = Arena::from_vmem(1ull << 26, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ cache_arena.vmem_release(); };
+		auto cache = ContactCache::create(&cache_arena, count * 4);
+
+		f64 uncached_ms = 0;
+		f64 cached_ms = 0;
+		u64 queries = 0;
+		u64 reused = 0;
+		for (auto t : u32xrange{ 0, ticks + 1 }) {
+			step_arena.reset();
+			if (t > 0)
+				jitter(rng, moving, 0.01f);
+			auto step = make_step(step_arena, colliders);
+			broadphase_naive(step, detections);
+			{
+				auto timer = Stopwatch{};
+				query_collisions(step_arena, step.tests.used(), step.colliders.used());
+				if (t > 0) uncached_ms += timer.ms();
+			}
+			cache.next_tick();
+			{
+				auto timer = Stopwatch{};
+				query_collisions(step_arena, step.tests.used(), step.colliders.used(), { .contacts = &cache });
+				if (t > 0) cached_ms += timer.ms();
+			}
+			if (t > 0) {
+				queries += cache.stats.queries;
+				reused += cache.stats.reused;
+			}
+		}
+
+		printf("contact reuse %5u colliders, %3.0f%% moving | uncached %8.3f ms/tick | cached %8.3f ms/tick, %.1f%% reused\n",
+			count, moving_ratio * 100, uncached_ms / ticks, cached_ms / ticks, 100.0 * f64(reused) / f64(max<u64>(1, queries))
+		);
+	}
+
+	//* column of boxes dropped on static ground, how fast does it settle & what does it cost per tick
+	void solver_stack(Arena& arena, u32 height, Solver solver, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto box = Convex::make(rtf32{ v2f32(-0.5f), v2f32(+0.5f) }, 0);
+		auto ground = Convex::make(rtf32{ v2f32(-50, -1), v2f32(50, 0) }, 0);
+		auto bodies = scratch.push_array<Body>(height + 1);
+		auto rotations = scratch.push_array<f32>(height + 1);
+		bodies[0] = { .center_mass = v2f32(0), .momentum = {}, .props = { .vec = v4f32(0, 0, 0.2f, 0.6f) } };
+		for (auto i : u32xrange{ 1, height + 1 })
+			bodies[i] = { .center_mass = v2f32(0, f32(i) - 0.49f), .momentum = {}, .props = { .vec = v4f32(1, 6, 0.2f, 0.6f) } };
+		for (auto& r : rotations)
+			r = 0;
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto cache_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ cache_arena.vmem_release(); };
+		auto contacts = ContactCache::create(&cache_arena, height * 4, 0, 0);//* no reuse, only impulse persistence
+
+		f64 solve_ms = 0;
+		f32 residual_speed = 0;
+		f32 max_depth = 0;
+		constexpr f32 dt = 1.f / 60.f;
+		for (auto t : u32xrange{ 0, ticks }) {
+			step_arena.reset();
+			auto step = SimStep::create(&step_arena, dt, height + 1, height + 1);
+			for (auto i : u32xrange{ 0, height + 1 }) {
+				auto& body = bodies[i];
+				if (body.props.inverse_mass > 0) {
+					body.momentum.velocity += v2f32(0, -EARTH_GRAVITY) * dt;
+					body.center_mass += body.momentum.velocity * dt;
+					rotations[i] += body.momentum.angular_velocity * dt;
+				}
+				step.push_body(body);
+				m3x3f32 transform = Transform2D{ .translation = body.center_mass, .scale = v2f32(1), .rotation = rotations[i] };
+				step.push_collider({
+					.transform = transform,
+					.aabb = aabb_convex(i == 0 ? ground : box, transform),
+					.shape = i == 0 ? &ground : &box,
+					.body_id = i32(i),
+					.layers = 1,
+					.uid = collider_uid(1, i + 1)
+				});
+			}
+			broadphase_naive(step, detections);
+			contacts.next_tick();
+			auto manifolds = query_collisions(step_arena, step.tests.used(), step.colliders.used(), { .contacts = &contacts });
+			auto timer = Stopwatch{};
+			auto deltas = solver(step_arena, step.bodies.used(), step.colliders.used(), manifolds, dt, &contacts);
+			solve_ms += timer.ms();
+			auto resolved = apply_resolution(step.bodies.used(), deltas);
+			for (auto i : u32xrange{ 0, height + 1 })
+				bodies[i] = resolved[i];
+			if (t + 10 >= ticks) {//* last 10 ticks
+				for (auto& body : bodies.subspan(1))
+					residual_speed = max(residual_speed, glm::length(body.momentum.velocity));
+				for (auto& m : manifolds)
+					max_depth = max(max_depth, glm::length(m.ctc.penetration));
+			}
+		}
+
+		printf("solver stack of %2u | %-10s %2u iterations%s | %8.4f ms/tick | settled max speed %.4f, max depth %.4f\n",
+			height, Solver::modes[solver.mode], solver.sequential.velocity_iterations, solver.sequential.warm_start ? ", warm" : "      ",
+			solve_ms / ticks, residual_speed, max_depth
+		);
+	}
+
+	//* parallel narrowphase from 1 to every core, checked against the serial manifolds byte for byte
+	void narrowphase_scaling(Arena& arena, JobPool& jobs, u32 count, u32 sides, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto rng = Rng{};
+		auto shape = regular_polygon(scratch, sides);
+		auto colliders = random_colliders(scratch, rng, count, shape, 1.f);
+		auto step_arena = Arena::from_vmem(1ull << 26, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto step = make_step(step_arena, colliders);
+		broadphase_naive(step, detections);
+		auto reference = query_collisions(step_arena, step.tests.used(), step.colliders.used());
+
+		f64 serial_ms = 0;
+		for (auto t : u32xrange{ 0, ticks }) {
+			(void)t;
+			auto timer = Stopwatch{};
+			query_collisions(step_arena, step.tests.used(), step.colliders.used());
+			serial_ms += timer.ms();
+		}
+		printf("narrowphase scaling %5u colliders, %2u sided polygons, %llu tests | serial %8.3f ms/tick\n", count, sides, u64(step.tests.current), serial_ms / ticks);
+
+		auto cores = max(1u, std::thread::hardware_concurrency());
+		for (auto workers : u32xrange{ 1, cores + 1 }) {
+			jobs.start(workers);
+			f64 parallel_ms = 0;
+			auto identical = true;
+			for (auto t : u32xrange{ 0, ticks }) {
+				(void)t;
+				auto timer = Stopwatch{};
+				auto manifolds = query_collisions_parallel(step_arena, jobs, step.tests.used(), step.colliders.used());
+				parallel_ms += timer.ms();
+				identical &= manifolds.size() == reference.size() && memcmp(manifolds.data(), reference.data(), reference.size_bytes()) == 0;
+			}
+			printf("    %2u workers | %8.3f ms/tick | x%5.2f | %s\n", workers, parallel_ms / ticks, serial_ms / parallel_ms, identical ? "identical" : "MISMATCH");
+		}
+		jobs.stop();
+	}
+
+	//* rows of box columns on a shared static ground, coloured solve from 1 to every core, checked against the serial coloured deltas
+	void solver_scaling(Arena& arena, JobPool& jobs, u32 columns, u32 height, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto box = Convex::make(rtf32{ v2f32(-0.5f), v2f32(+0.5f) }, 0);
+		auto ground = Convex::make(rtf32{ v2f32(-1, -1), v2f32(f32(columns) * 2 + 1, 0) }, 0);
+		auto step_arena = Arena::from_vmem(1ull << 26, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto count = columns * height + 1;
+		auto step = SimStep::create(&step_arena, 1.f / 60.f, count, count);
+		for (auto i : u32xrange{ 0, count }) {
+			auto x = f32((i - 1) % max(1u, columns)) * 2;
+			auto y = f32((i - 1) / max(1u, columns)) + 0.49f;//* slightly overlapping so every box has contacts
+			auto center = i == 0 ? v2f32(0) : v2f32(x, y);
+			step.push_body({ .center_mass = center, .momentum = { .vec = v3f32(0, -1, 0) }, .props = { .vec = i == 0 ? v4f32(0, 0, 0.2f, 0.6f) : v4f32(1, 6, 0.2f, 0.6f) } });
+			m3x3f32 transform = Transform2D{ .translation = center, .scale = v2f32(1), .rotation = 0 };
+			step.push_collider({
+				.transform = transform,
+				.aabb = aabb_convex(i == 0 ? ground : box, transform),
+				.shape = i == 0 ? &ground : &box,
+				.body_id = i32(i),
+				.layers = 1,
+				.uid = collider_uid(1, i + 1)
+			});
+		}
+		broadphase_naive(step, detections);
+		auto manifolds = query_collisions(step_arena, step.tests.used(), step.colliders.used());
+
+		auto solve_ms = [&](SequentialImpulses& solver, JobPool* pool, Array<const Delta> reference, bool& identical) {
+			f64 ms = 0;
+			for (auto t : u32xrange{ 0, ticks }) {
+				(void)t;
+				auto timer = Stopwatch{};
+				auto deltas = solver(step_arena, step.bodies.used(), step.colliders.used(), manifolds, step.dt, null, pool);
+				ms += timer.ms();
+				identical &= deltas.size() == reference.size() && memcmp(deltas.data(), reference.data(), reference.size_bytes()) == 0;
+			}
+			return ms;
+		};
+
+		auto serial = SequentialImpulses{ .graph_colouring = false };
+		auto coloured = SequentialImpulses{};
+		auto reference = coloured(step_arena, step.bodies.used(), step.colliders.used(), manifolds, step.dt);
+		auto ignored = true;
+		auto serial_ms = solve_ms(serial, null, serial(step_arena, step.bodies.used(), step.colliders.used(), manifolds, step.dt), ignored);
+		printf("solver scaling %5u bodies, %llu contacts | uncoloured %8.3f ms/tick | %u colours, batches", count, u64(manifolds.size()), serial_ms / ticks, coloured.colouring.colours);
+		for (auto c : u32xrange{ 0, coloured.colouring.colours })
+			printf(" %u", coloured.colouring.batch_sizes[c]);
+		printf(", overflow %u\n", coloured.colouring.batch_sizes[SequentialImpulses::MAX_COLOURS]);
+
+		auto cores = max(1u, std::thread::hardware_concurrency());
+		for (auto workers : u32xrange{ 1, cores + 1 }) {
+			jobs.start(workers);
+			auto identical = true;
+			auto parallel_ms = solve_ms(coloured, &jobs, reference, identical);
+			printf("    %2u workers | %8.3f ms/tick | x%5.2f | %s\n", workers, parallel_ms / ticks, serial_ms / parallel_ms, identical ? "identical" : "MISMATCH");
+		}
+		jobs.stop();
+	}
+
+	//* single layer terrain of size x size unit square tiles, fill(cells) sets the solid cells to 1 over a zeroed grid
+	//* returns it with its bake time, everything it references lives on the arena
+	template<typename F> tuple<Tilemap::Terrain, f64> grid_terrain(Arena& arena, u32 size, bool merge, const F& fill) {
+		using namespace Tilemap;
+		auto full_shape = arena.push_array<Shape>(1);
+		full_shape[0] = { Convex::make(rtf32{ v2f32(0), v2f32(1) }, 0), m3x3f32(1) };
+		auto tiles = arena.push_array<TileCollider>(2);
+		tiles[0] = { .shapes = {}, .transform = m3x3f32(1) };
+		tiles[1] = { .shapes = full_shape, .transform = m3x3f32(1) };
+		auto cells = arena.push_array<u32>(u64(size) * size);
+		for (auto& cell : cells)
+			cell = 0;
+		fill(cells);
+		auto& layer = arena.push(Terrain::Collider{
+			.cells = { .data = cells, .dimensions = v2u32(size) },
+			.aabb = { v2f32(0), v2f32(size) },
+			.collision_layers = 1,
+			.baked = {},
+			.cell_offsets = {},
+			.cell_refs = {}
+		});
+		auto bake_timer = Stopwatch{};
+		Terrain::bake_layer(arena, layer, 0, tiles, merge);
+		auto bake_ms = bake_timer.ms();
+		return { Terrain{ .layers = carray(&layer, 1), .tiles = tiles }, bake_ms };
+	}
+
+	//* boxes wandering over a large mostly empty layer with a floor & scattered platforms
+	//* the terrain broadphase cost should follow the overlapped cells, not the layer's area
+	void terrain_broadphase(Arena& arena, u32 size, u32 count, bool merge, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto rng = Rng{};
+
+		auto [terrain, bake_ms] = grid_terrain(scratch, size, merge, [&](Array<u32> cells) {
+			for (auto x : u32xrange{ 0, size })//* floor
+				cells[u64(size - 1) * size + x] = 1;
+			for (u32 i = 0; i < size * size / 4096; i++) {//* 8 wide platforms
+				auto x = u32(rng.range(0, f32(size - 8))), y = u32(rng.range(0, f32(size - 2)));
+				for (auto w : u32xrange{ 0, 8 })
+					cells[u64(y) * size + x + w] = 1;
+			}
+		});
+
+		auto box = Convex::make(rtf32{ v2f32(-0.5f), v2f32(+0.5f) }, 0);
+		auto positions = scratch.push_array<v2f32>(count);
+		auto velocities = scratch.push_array<v2f32>(count);
+		for (auto i : u32xrange{ 0, count }) {
+			positions[i] = rng.point({ v2f32(1), v2f32(f32(size - 1)) });
+			velocities[i] = v2f32(rng.range(-1, 1), rng.range(-1, 1)) * 10.f;
+		}
+		if (count > 0)
+			positions[0] = v2f32(f32(size) / 2, 1.2f);//* at least one sitting on the floor
+
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		f64 broadphase_ms = 0;
+		u64 tests = 0;
+		for (auto t : u32xrange{ 0, ticks }) {
+			(void)t;
+			step_arena.reset();
+			auto step = SimStep::create(&step_arena, 1.f / 60.f, count + 1, count * 4);
+			for (auto i : u32xrange{ 0, count }) {
+				positions[i] += velocities[i] * step.dt;
+				for (auto axis : u32xrange{ 0, 2 }) if (positions[i][axis] < 1 || positions[i][axis] > f32(size - 1))
+					velocities[i][axis] = -velocities[i][axis];
+				auto body = step.push_body({ .center_mass = positions[i], .momentum = {}, .props = { .vec = v4f32(1, 6, 0.2f, 0.6f) } });
+				m3x3f32 transform = Transform2D{ .translation = positions[i], .scale = v2f32(1), .rotation = 0 };
+				step.push_collider({ .transform = transform, .aabb = aabb_convex(box, transform), .shape = &box, .body_id = i32(body), .layers = 1 });
+			}
+			auto timer = Stopwatch{};
+			tests += Tilemap::terrain_broadphase(step, terrain, detections).size();
+			broadphase_ms += timer.ms();
+		}
+		printf("terrain %4ux%-4u %-8s | bake %8.2f ms, %7llu pieces | %3u bodies | broadphase %8.4f ms/tick, %5.1f tests/tick\n",
+			size, size, merge ? "merged" : "unmerged", bake_ms, u64(terrain.layers[0].baked.size()), count, broadphase_ms / ticks, f64(tests) / ticks
+		);
+	}
+
+	//* hundreds of line of sight checks between agents scattered among bodies & terrain, one raycast_batch call per tick
+	void line_of_sight(Arena& arena, JobPool& jobs, u32 agents, u32 bodies, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		using namespace Tilemap;
+		auto detections = FlagMatrix<u32>::create_fill();
+		auto rng = Rng{};
+
+		constexpr u32 size = 256;
+		auto [terrain, bake_ms] = grid_terrain(scratch, size, true, [&](Array<u32> cells) {
+			for (auto& cell : cells)
+				cell = rng.unit() < 0.05f ? 1 : 0;
+		});
+		(void)bake_ms;
+
+		auto colliders = random_colliders(scratch, rng, bodies, Convex::UNIT_CIRCLE());
+		for (auto& col : colliders) {//* random_colliders centers them on the origin, move them over the terrain
+			col.transform[2] += v3f32(f32(size) / 2, f32(size) / 2, 0);
+			col.aabb = aabb_convex(*col.shape, col.transform);
+		}
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto step = make_step(step_arena, colliders);
+		auto broadphase = Broadphase::create(&step_arena, Broadphase::TREE, bodies);
+		broadphase(step, detections);
+		auto scene = QueryScene{ .colliders = step.colliders.used(), .broadphase = &broadphase };
+		auto terrain_query = TerrainQuery{ terrain };
+
+		auto rays = scratch.push_array<Ray>(agents);
+		for (auto& ray : rays) {
+			ray.origin = rng.point({ v2f32(1), v2f32(f32(size - 1)) });
+			ray.displacement = rng.point({ v2f32(1), v2f32(f32(size - 1)) }) - ray.origin;
+		}
+
+		auto run = [&](JobPool* pool) {
+			f64 ms = 0;
+			u64 blocked = 0;
+			for (auto t : u32xrange{ 0, ticks }) {
+				(void)t;
+				auto [results, results_scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(results, results_scope); };
+				auto timer = Stopwatch{};
+				auto hits = raycast_batch(results, rays, {}, pool, scene, terrain_query);
+				ms += timer.ms();
+				blocked = 0;
+				for (auto& hit : hits)
+					blocked += hit.collider ? 1 : 0;
+			}
+			return tuple<f64, u64>{ ms / ticks, blocked };
+		};
+		auto [serial_ms, serial_blocked] = run(null);
+		jobs.start();
+		auto [parallel_ms, parallel_blocked] = run(&jobs);
+		auto workers = jobs.worker_count();
+		jobs.stop();
+		if (serial_blocked != parallel_blocked)
+			fprintf(stderr, "line of sight mismatch : serial %llu blocked, parallel %llu blocked\n", serial_blocked, parallel_blocked);
+
+		printf("line of sight %4u rays, %5u bodies, %6llu terrain pieces | serial %8.3f ms/tick | %2u workers %8.3f ms/tick | %llu blocked\n",
+			agents, bodies, u64(terrain.layers[0].baked.size()), serial_ms, workers, parallel_ms, serial_blocked
+		);
+	}
+
+	//* rollback netcode pattern -> snapshot every tick, then rewind window ticks & re-simulate them, as a late input would
+	//* the re-simulated ticks must hash the same as the first time through, every piece of persistent state was restored
+	void rollback(Arena& arena, u32 count, u32 window, u32 rounds) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		constexpr f32 dt = 1.f / 60.f;
+		auto scene = box_pile(scratch, count);
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto persistent = Arena::from_vmem(1ull << 26, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ persistent.vmem_release(); };
+		auto pipeline = Pipeline::create(&persistent, scene.size(), Broadphase::TREE, Solver::SEQUENTIAL, true);
+		auto state = SimState{
+			.bodies = scene.bodies,
+			.user = carray((u8*)scene.rotations.data(), scene.rotations.size_bytes()),
+			.broadphase = &pipeline.broadphase,
+			.gjk = &pipeline.gjk,
+			.contacts = &pipeline.contacts,
+			.sleep = &pipeline.sleep
+		};
+		auto tick = [&]() { return pipeline.tick(step_arena, scene, dt); };
+
+		for (auto t : u32xrange{ 0, 30 }) {//* let the pile start colliding so the caches & tree are busy
+			(void)t;
+			tick();
+		}
+
+		//* ring of the last window + 1 snapshots, slot t % (window + 1) holds the state before tick t
+		//* buffers are regrown when the state outgrows them, caches & sleep states keep growing as the pile settles
+		auto blob_size = Snapshot::size(state);
+		auto buffers = scratch.push_array<Array<u8>>(window + 1);
+		auto ring = scratch.push_array<Array<u8>>(window + 1);
+		for (auto& blob : buffers)
+			blob = scratch.push_array<u8>(blob_size * 2);
+		auto snapshot = [&](u32 slot) {
+			auto needed = Snapshot::size(state);
+			if (buffers[slot].size() < needed)
+				buffers[slot] = scratch.push_array<u8>(needed * 2);
+			ring[slot] = Snapshot::save(buffers[slot], state);
+		};
+		auto hashes = scratch.push_array<u64>(window);
+
+		f64 save_ms = 0, restore_ms = 0, resim_ms = 0, delta_ms = 0;
+		u64 delta_bytes = 0, deltas = 0;
+		auto identical = true;
+		for (auto round : u32xrange{ 0, rounds }) {
+			(void)round;
+			for (auto t : u32xrange{ 0, window }) {
+				auto timer = Stopwatch{};
+				snapshot(t);
+				save_ms += timer.ms();
+				hashes[t] = tick();
+				if (t > 0) {
+					auto [delta_scratch, delta_scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(delta_scratch, delta_scope); };
+					auto delta_timer = Stopwatch{};
+					auto delta = Snapshot::delta(delta_scratch, ring[t - 1], ring[t]);
+					delta_ms += delta_timer.ms();
+					delta_bytes += delta.size();
+					deltas++;
+					auto rebuilt = Snapshot::apply_delta(delta_scratch, ring[t - 1], delta);
+					identical &= rebuilt.size() == ring[t].size() && memcmp(rebuilt.data(), ring[t].data(), rebuilt.size()) == 0;
+				}
+			}
+			snapshot(window);
+			{
+				auto timer = Stopwatch{};
+				Snapshot::restore(ring[0], state);
+				restore_ms += timer.ms();
+			}
+			{
+				auto timer = Stopwatch{};
+				for (auto t : u32xrange{ 0, window })
+					identical &= tick() == hashes[t];
+				resim_ms += timer.ms();
+			}
+			//* the state after re-simulating must be the same bytes as the one saved before rewinding
+			auto [check_scratch, check_scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(check_scratch, check_scope); };
+			auto after = Snapshot::save(check_scratch, state);
+			identical &= after.size() == ring[window].size() && memcmp(after.data(), ring[window].data(), after.size()) == 0;
+		}
+		if (!identical)
+			fprintf(stderr, "rollback of %u bodies diverged from the first simulation\n", count);
+
+		printf("rollback %4u bodies, %u ticks | snapshot %7.1f kB, save %7.4f ms, delta %6.1f kB in %7.4f ms | restore %7.4f ms + resimulate %7.3f ms = %7.3f ms\n",
+			count, window, f64(blob_size) / 1024, save_ms / (rounds * window),
+			f64(delta_bytes) / f64(max<u64>(1, deltas)) / 1024, delta_ms / f64(max<u64>(1, deltas)),
+			restore_ms / rounds, resim_ms / rounds, (restore_ms + resim_ms) / rounds
+		);
+	}
+
+	//* frames of several ticks each on a falling pile, the whole pipeline every tick vs a broadphase per frame on reach_aabbs
+	void substepping(Arena& arena, u32 count, u32 ticks_per_frame, bool substep, u32 frames) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		constexpr f32 dt = 1.f / 60.f;
+		auto scene = box_pile(scratch, count);
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto persistent = Arena::from_vmem(1ull << 26, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ persistent.vmem_release(); };
+		auto pipeline = Pipeline::create(&persistent, scene.size());
+
+		f64 broad_ms = 0, frame_ms = 0;
+		u64 tests = 0, manifolds_count = 0;
+		for (auto frame : u32xrange{ 0, frames }) {
+			(void)frame;
+			auto frame_timer = Stopwatch{};
+			auto passes = substep ? 1 : ticks_per_frame;
+			for (auto pass : u32xrange{ 0, passes }) {
+				(void)pass;
+				step_arena.reset();
+				auto step = SimStep::create(&step_arena, dt, scene.size(), scene.size());
+				scene.integrate(dt, pipeline.sleep);
+				auto timer = Stopwatch{};
+				scene.submit(step);
+				if (substep)
+					step.reach_aabbs(dt * f32(ticks_per_frame), v2f32(0, -EARTH_GRAVITY), SubStepping{}.margin);
+				pipeline.broadphase(step, pipeline.detections);
+				broad_ms += timer.ms();
+				tests += step.tests.current;
+
+				for (auto tick : u32xrange{ 0, substep ? ticks_per_frame : 1 }) {
+					if (tick > 0) {
+						scene.integrate(dt, pipeline.sleep);
+						scene.repose(step);
+					}
+					manifolds_count += pipeline.resolve(step_arena, step, scene).size();
+				}
+			}
+			frame_ms += frame_timer.ms();
+		}
+		printf("substepping %5u bodies, %2u ticks/frame %-9s | broadphase %8.4f ms/frame, %7llu tests/frame | %6llu manifolds/frame | frame %8.3f ms\n",
+			count, ticks_per_frame, substep ? "substeps" : "full", broad_ms / frames, tests / frames, manifolds_count / frames, frame_ms / frames
+		);
+	}
+
+	//* small fast projectile fired at a 1 unit thick static wall at 60 Hz, without sub-steps, does it come out the other side
+	void projectile_tunneling(Arena& arena, f32 speed, bool ccd, u32 ticks) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto detections = FlagMatrix<u32>::create_fill();
+		v2f32 center[] = { v2f32(0) };
+		auto bullet = Convex::make(larray(center), 0.1f);
+		auto wall = Convex::make(rtf32{ v2f32(-0.5f, -5), v2f32(0.5f, 5) }, 0);
+		auto solver = SequentialImpulses{};
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+
+		Body body = { .center_mass = v2f32(-10, 0.3f), .momentum = { .vec = v3f32(speed, 0, 0) }, .props = { .vec = v4f32(10, 0, 0.2f, 0.2f) } };
+		constexpr f32 dt = 1.f / 60.f;
+		f64 narrow_ms = 0;
+		u64 contacts = 0;
+		for (auto t : u32xrange{ 0, ticks }) {
+			(void)t;
+			step_arena.reset();
+			auto sweep = body.momentum.velocity * dt;
+			body.center_mass += sweep;
+			auto step = SimStep::create(&step_arena, dt, 2, 2);
+			step.push_body({ .center_mass = v2f32(0), .momentum = {}, .props = { .vec = v4f32(0, 0, 0.2f, 0.2f) } });
+			step.push_body(body);
+			m3x3f32 wall_transform = Transform2D{ .translation = v2f32(0), .scale = v2f32(1), .rotation = 0 };
+			m3x3f32 bullet_transform = Transform2D{ .translation = body.center_mass, .scale = v2f32(1), .rotation = 0 };
+			step.push_collider({ .transform = wall_transform, .aabb = {}, .shape = &wall, .body_id = 0, .layers = 1, .uid = collider_uid(1, 1) });
+			step.push_collider({ .transform = bullet_transform, .aabb = {}, .shape = &bullet, .body_id = 1, .layers = 1, .uid = collider_uid(1, 2), .sweep = ccd ? sweep : v2f32(0) });
+			aabb_colliders(step.colliders.used());
+			broadphase_naive(step, detections);
+			auto timer = Stopwatch{};
+			auto manifolds = query_collisions(step_arena, step.tests.used(), step.colliders.used());
+			narrow_ms += timer.ms();
+			contacts += manifolds.size();
+			auto deltas = solver(step_arena, step.bodies.used(), step.colliders.used(), manifolds, dt);
+			body = apply_resolution(step.bodies.used(), deltas)[1];
+		}
+		auto tunneled = body.center_mass.x > 0.5f;
+		printf("projectile %6.1f u/s %-8s | %s at x %8.3f | %llu contacts | narrowphase %8.4f ms/tick\n",
+			speed, ccd ? "ccd" : "discrete", tunneled ? "TUNNELED" : "stopped ", body.center_mass.x, contacts, narrow_ms / ticks
+		);
+	}
+
+	//* previous EPA, ordered array polytope rescanned every iteration, kept as the baseline
+	template<support_function F1, support_function F2> v2f32 epa_ordered(const F1& f1, const F2& f2, const Triangle& triangle, u32 max_iteration, f32 precision_threshold) {
+		v2f32 points_buffer[max_iteration + 3];
+		auto points = List{ carray(points_buffer, max_iteration + 3), 0 };
+		points.push(larray(triangle.vertices));
+
+		auto best_point_index = 0;
+		while (max_iteration-- > 0) {
+			auto O = average(points.used());
+			struct { f32 distance_to_origin = xf32::max(); v2f32 normal = v2f32(0); u64 pindex = 0; } closest_seg;
+			for (auto i : u64xrange{ 0, points.current }) {
+				auto j = (i + 1) % points.current;
+				auto seg = Segment{ points[i], points[j] };
+				auto normal_axis = orthogonal_axis(direction(seg));
+				auto side = sign(glm::dot(normal_axis, seg.A - O));
+				if (side == 0) {
+					closest_seg = { 0, glm::normalize(normal_axis), j };
+				} else {
+					v2f32 normal = glm::normalize(side * normal_axis);
+					auto dist_to_ori = glm::abs(glm::dot(normal, seg.A));
+					if (dist_to_ori < closest_seg.distance_to_origin)
+						closest_seg = { dist_to_ori, normal, j };
+				}
+			}
+			auto support_point = minkowski_diff_support(f1, f2, closest_seg.normal);
+			if (glm::dot(closest_seg.normal, support_point) - closest_seg.distance_to_origin <= precision_threshold)
+				return closest_seg.normal * closest_seg.distance_to_origin;
+			points.insert_ordered(best_point_index = closest_seg.pindex, support_point);
+		}
+		return points[best_point_index];
+	}
+
+	//* nearly concentric round polygons, EPA has to walk most of the boundary before converging
+	void deep_penetration(Arena& arena, u32 sides, u32 queries, u32 max_iteration) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto rng = Rng{};
+		auto shape = regular_polygon(scratch, sides);
+		auto a = support_function_of(shape, Transform2D{ .translation = v2f32(0), .scale = v2f32(1), .rotation = 0 });
+		auto transforms = scratch.push_array<m3x3f32>(queries);
+		for (auto& t : transforms)
+			t = Transform2D{ .translation = rng.point({ v2f32(-0.05f), v2f32(+0.05f) }), .scale = v2f32(1), .rotation = rng.range(0, 360) };
+		auto simplices = scratch.push_array<Triangle>(queries);
+		for (auto i : u32xrange{ 0, queries }) {
+			auto [collided, simplex] = GJK(a, support_function_of(shape, transforms[i]));
+			simplices[i] = simplex;
+		}
+
+		f64 heap_ms = 0;
+		f64 ordered_ms = 0;
+		f32 max_deviation = 0;
+		for (auto i : u32xrange{ 0, queries }) {
+			auto b = support_function_of(shape, transforms[i]);
+			v2f32 results[2];
+			{
+				auto timer = Stopwatch{};
+				results[0] = EPA(a, b, simplices[i], max_iteration, 1e-4f);
+				heap_ms += timer.ms();
+			}
+			{
+				auto timer = Stopwatch{};
+				results[1] = epa_ordered(a, b, simplices[i], max_iteration, 1e-4f);
+				ordered_ms += timer.ms();
+			}
+			max_deviation = max(max_deviation, glm::length(results[0] - results[1]));
+		}
+
+		printf("deep penetration %3u sided polygons, %3u iterations max | heap polytope %8.3f us/query | ordered array %8.3f us/query | max deviation %.5f\n",
+			sides, max_iteration, heap_ms * 1e3 / queries, ordered_ms * 1e3 / queries, max_deviation
+		);
+	}
+
+	void support_search(Arena& arena, u32 sides, u32 queries) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto shape = regular_polygon(scratch, sides);
+		auto cloud = world_cloud(scratch, shape, Transform2D{ .translation = v2f32(3, -2), .scale = v2f32(1), .rotation = 30 });
+		auto directions = scratch.push_array<v2f32>(queries);
+		for (auto i : u32xrange{ 0, queries }) {
+			auto angle = glm::two_pi<f32>() * f32(i) / f32(queries);
+			directions[i] = v2f32(glm::cos(angle), glm::sin(angle));
+		}
+
+		i64 checksum[2] = { 0, 0 };
+		f64 simd_ms = 0;
+		f64 scalar_ms = 0;
+		{
+			auto timer = Stopwatch{};
+			for (auto dir : directions) {
+				auto [a, b] = support_top_two(cloud, dir);
+				checksum[0] += a * 31 + b;
+			}
+			simd_ms = timer.ms();
+		}
+		{
+			auto timer = Stopwatch{};
+			for (auto dir : directions) {
+				auto best = SupportCandidate::none();
+				auto second = SupportCandidate::none();
+				top_two_scalar(cloud, dir, 0, best, second);
+				checksum[1] += best.index * 31 + (second.index < 0 ? best.index : second.index);
+			}
+			scalar_ms = timer.ms();
+		}
+		if (checksum[0] != checksum[1])
+			fprintf(stderr, "support search mismatch on %u sided polygon\n", sides);
+
+		printf("support search %2u vertices | simd %8.3f ns/query | scalar %8.3f ns/query\n",
+			sides, simd_ms * 1e6 / queries, scalar_ms * 1e6 / queries
+		);
+	}
+
+	//* all pairs of count layer masks through a random matrix, multi_layer of the masks sit on 2 layers
+	void layer_filter(Arena& arena, u32 count, f32 multi_layer) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto rng = Rng{};
+		auto matrix = FlagMatrix<u32>::create_fill(false);
+		for (auto y : u32xrange{ 0, 32 }) for (auto x : u32xrange{ y, 32 })
+			matrix.set(v2u32(x, y), rng.unit() < 0.3f);
+		auto layers = scratch.push_array<u32>(count);
+		for (auto& mask : layers) {
+			mask = FlagMatrix<u32>::mask_idx(u32(rng.next() % 32));
+			if (rng.unit() < multi_layer)
+				mask |= FlagMatrix<u32>::mask_idx(u32(rng.next() % 32));
+		}
+		auto matches = scratch.push_array<u64>((count + 63) / 64);
+
+		u64 found[3] = { 0, 0, 0 };
+		f64 ms[3] = { 0, 0, 0 };
+		{//* what mask_match did before the matrix was compiled
+			auto timer = Stopwatch{};
+			for (auto i : u32xrange{ 0, count }) for (auto j : u32xrange{ 0, count }) for (auto r : u32xrange{ 0, 32 })
+				if ((layers[i] & FlagMatrix<u32>::mask_idx(r)) && (matrix.rows[r] & layers[j])) {
+					found[0]++;
+					break;
+				}
+			ms[0] = timer.ms();
+		}
+		{
+			auto timer = Stopwatch{};
+			for (auto i : u32xrange{ 0, count }) for (auto j : u32xrange{ 0, count })
+				found[1] += matrix.mask_match(layers[i], layers[j]) ? 1 : 0;
+			ms[1] = timer.ms();
+		}
+		{
+			auto timer = Stopwatch{};
+			for (auto i : u32xrange{ 0, count })
+				found[2] += matrix.match_many(layers[i], layers, matches);
+			ms[2] = timer.ms();
+		}
+		if (found[0] != found[1] || found[0] != found[2])
+			fprintf(stderr, "layer filter mismatch : loop %llu, lookup %llu, batch %llu\n", found[0], found[1], found[2]);
+
+		auto pairs = f64(count) * count;
+		printf("layer filter %5u masks, %3.0f%% multi layer | row loop %6.3f ns/pair | lookup %6.3f ns/pair | batch %6.3f ns/pair | %llu matches\n",
+			count, multi_layer * 100, ms[0] * 1e6 / pairs, ms[1] * 1e6 / pairs, ms[2] * 1e6 / pairs, found[0]
+		);
+	}
+
+}
+
+i32 main() {
+	auto arena = Arena::from_vmem(1ull << 30, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ arena.vmem_release(); };
+	static JobPool jobs;
+	for (auto count : { 100u, 1000u, 10000u })
+		Bench::broadphase(arena, count, 10);
+	for (auto count : { 1000u, 10000u })
+		Bench::collider_layout(arena, count, 10);
+	for (auto sides : { 4u, 8u, 16u })
+		Bench::narrowphase(arena, 1000, sides, 10);
+	{
+		auto rect = Convex::make(rtf32{ v2f32(-0.5f), v2f32(+0.5f) }, 0);
+		v2f32 center[] = { v2f32(0) };
+		v2f32 foci[] = { v2f32(0, -0.25f), v2f32(0, +0.25f) };
+		auto circle = Convex::make(larray(center), 0.5f);
+		auto capsule = Convex::make(larray(foci), 0.25f);
+		Bench::shape_pairs(arena, 1000, circle, rect, 10);
+		Bench::shape_pairs(arena, 1000, capsule, rect, 10);
+		Bench::shape_pairs(arena, 1000, rect, rect, 10);
+		Bench::shape_pairs(arena, 1000, circle, capsule, 10);
+	}
+	for (auto sides : { 4u, 8u, 16u })
+		Bench::gjk_warm_start(arena, 1000, sides, 10);
+	for (auto moving : { 0.1f, 0.5f, 1.f })
+		Bench::contact_reuse(arena, 1000, moving, 10);
+	Bench::solver_stack(arena, 10, { .mode = Solver::AVERAGED, .sequential = {} }, 300);
+	for (auto iterations : { 1u, 4u, 8u, 16u }) for (auto warm : { false, true })
+		Bench::solver_stack(arena, 10, { .mode = Solver::SEQUENTIAL, .sequential = { .velocity_iterations = iterations, .warm_start = warm } }, 300);
+	Bench::narrowphase_scaling(arena, jobs, 10000, 8, 10);
+	Bench::solver_scaling(arena, jobs, 200, 10, 10);
+	for (auto merge : { false, true })
+		Bench::terrain_broadphase(arena, 4096, 48, merge, 60);
+	for (auto speed : { 30.f, 120.f, 600.f }) for (auto ccd : { false, true })
+		Bench::projectile_tunneling(arena, speed, ccd, 120);
+	for (auto agents : { 100u, 500u })
+		Bench::line_of_sight(arena, jobs, agents, 1000, 10);
+	Bench::rollback(arena, 500, 8, 10);
+	for (auto ticks : { 2u, 4u, 8u }) for (auto substep : { false, true })
+		Bench::substepping(arena, 1000, ticks, substep, 30);
+	for (auto sides : { 16u, 64u, 256u })
+		Bench::deep_penetration(arena, sides, 1000, 128);
+	for (auto sides : { 4u, 8u, 16u, 64u })
+		Bench::support_search(arena, sides, 1 << 20);
+	for (auto multi_layer : { 0.f, 0.5f })
+		Bench::layer_filter(arena, 4096, multi_layer);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef GPHYSICS_REPLAY
+# define GPHYSICS_REPLAY
+
+//* Deterministic replay check -> `make replay`, builds this at -O0 & -O2 in deterministic mode & diffs their per tick state hashes
+//* each run also replays the scene on the job pool & fails when the hashes depend on the thread count
+
+#include <blblstd.hpp>
+#include <math.cpp>
+#include <physics_2d.cpp>
+#include <physics_scene.cpp>
+
+namespace Replay {
+	using namespace Physics2D;
+	using namespace Bench;
+
+	constexpr f32 dt = 1.f / 60.f;
+
+	//* static ground & walls, then a grid of mixed shapes dropped with a little spin so they tumble & pile up
+	Scene make_scene(Arena& arena, u32 columns, u32 rows) {
+		static auto ground = Convex::make(rtf32{ v2f32(-20, -1), v2f32(20, 0) }, 0);
+		static auto wall = Convex::make(rtf32{ v2f32(-0.5f, 0), v2f32(0.5f, 30) }, 0);
+		static auto box = Convex::make(rtf32{ v2f32(-0.5f), v2f32(+0.5f) }, 0);
+		static v2f32 foci[] = { v2f32(0, -0.25f), v2f32(0, +0.25f) };
+		static auto capsule = Convex::make(larray(foci), 0.25f);
+		static v2f32 hexagon_vertices[6];
+		for (auto i : u32xrange{ 0, 6 }) {
+			auto angle = glm::two_pi<f32>() * f32(i) / 6.f;
+			hexagon_vertices[i] = v2f32(glm::cos(angle), glm::sin(angle)) * 0.5f;
+		}
+		static auto hexagon = Convex::make(larray(hexagon_vertices), 0);
+		const Convex* dynamic_shapes[] = { &box, &Convex::UNIT_CIRCLE(), &capsule, &hexagon };
+
+		auto count = 3 + columns * rows;
+		auto scene = Scene::create(arena, count);
+		v2f32 statics[] = { v2f32(0), v2f32(-12, 0), v2f32(12, 0) };
+		for (auto i : u32xrange{ 0, 3 }) {
+			scene.bodies[i] = { .center_mass = statics[i], .momentum = {}, .props = { .vec = v4f32(0, 0, 0.2f, 0.6f) } };
+			scene.shapes[i] = i == 0 ? &ground : &wall;
+		}
+		for (auto y : u32xrange{ 0, rows }) for (auto x : u32xrange{ 0, columns }) {
+			auto i = 3 + y * columns + x;
+			scene.bodies[i] = {
+				.center_mass = v2f32(f32(x) * 1.5f - f32(columns) * 0.75f + f32(y % 2) * 0.3f, 2 + f32(y) * 1.5f),
+				.momentum = { .vec = v3f32(0, 0, f32(i % 5) - 2) },
+				.props = { .vec = v4f32(1, 6, 0.2f, 0.6f) }
+			};
+			scene.shapes[i] = dynamic_shapes[i % array_size(dynamic_shapes)];
+		}
+		return scene;
+	}
+
+	//* the full pipeline with every cache on, hash of the bodies after each tick
+	void replay(Arena& arena, JobPool* jobs, Array<u64> hashes) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto scene = make_scene(scratch, 8, 10);
+		auto step_arena = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto persistent = Arena::from_vmem(1ull << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ persistent.vmem_release(); };
+		auto pipeline = Pipeline::create(&persistent, scene.size());
+		pipeline.jobs = jobs;
+
+		for (auto t : u32xrange{ 0, u32(hashes.size()) })
+			hashes[t] = pipeline.tick(step_arena, scene, dt);
+	}
+
+}
+
+i32 main() {
+	auto arena = Arena::from_vmem(1ull << 30, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ arena.vmem_release(); };
+	static JobPool jobs;
+	constexpr u32 ticks = 600;
+	auto serial = arena.push_array<u64>(ticks);
+	auto pooled = arena.push_array<u64>(ticks);
+	Replay::replay(arena, null, serial);
+	jobs.start();
+	Replay::replay(arena, &jobs, pooled);
+	jobs.stop();
+
+	if (!Physics2D::DETERMINISTIC)
+		fprintf(stderr, "built without PHYSICS_DETERMINISTIC, hashes may differ between builds\n");
+	for (auto t : u32xrange{ 0, ticks }) if (serial[t] != pooled[t]) {
+		fprintf(stderr, "replay diverged on the job pool at tick %u : serial %016llx, pooled %016llx\n", t, serial[t], pooled[t]);
+		return 1;
+	}
+	for (auto t : u32xrange{ 0, ticks })
+		printf("tick %4u %016llx\n", t, serial[t]);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef GPHYSICS_SCENE
+# define GPHYSICS_SCENE
+
+//* Scene & pipeline shared by the physics bench, replay & stress executables
+//* a Scene is bodies with a rotation & a shape each, a Pipeline owns the persistent state of every stage & runs ticks over a Scene
+//* the stages are separate calls so the executables timing them can lap in between
+
+#include <blblstd.hpp>
+#include <math.cpp>
+#include <physics_2d.cpp>
+
+namespace Bench {
+	using namespace Physics2D;
+
+	struct Scene {
+		Array<Body> bodies;
+		Array<f32> rotations;//* degrees, bodies only carry their translation
+		Array<const Convex*> shapes;
+
+		static Scene create(Arena& arena, u32 count) {
+			auto scene = Scene{
+				.bodies = arena.push_array<Body>(count),
+				.rotations = arena.push_array<f32>(count),
+				.shapes = arena.push_array<const Convex*>(count)
+			};
+			for (auto& r : scene.rotations)
+				r = 0;
+			return scene;
+		}
+
+		u32 size() const { return u32(bodies.size()); }
+		m3x3f32 transform(u32 i) const { return Transform2D{ .translation = bodies[i].center_mass, .scale = v2f32(1), .rotation = rotations[i] }; }
+
+		//* gravity then velocities into poses, static bodies & the ones sleep holds stay put
+		void integrate(f32 dt, const Sleep& sleep) {
+			for (auto i : u32xrange{ 0, size() }) {
+				auto& body = bodies[i];
+				if (body.props.inverse_mass > 0 && !sleep.sleeping(i)) {
+					body.momentum.velocity += v2f32(0, -EARTH_GRAVITY) * dt;
+					body.center_mass += body.momentum.velocity * dt;
+					rotations[i] += body.momentum.angular_velocity * dt;
+				}
+			}
+		}
+
+		//* body & collider i for every body, collider uids are keyed on the index
+		void submit(SimStep& step) const {
+			for (auto i : u32xrange{ 0, size() }) {
+				step.push_body(bodies[i]);
+				step.push_collider({
+					.transform = transform(i),
+					.aabb = {},
+					.shape = shapes[i],
+					.body_id = i32(i),
+					.layers = 1,
+					.uid = collider_uid(1, i + 1)
+				});
+			}
+			step.update_aabbs();
+		}
+
+		//* new poses for a step the scene was already submitted to, sub-steps keep the pairs of its broadphase
+		void repose(SimStep& step) const {
+			for (auto i : u32xrange{ 0, size() }) {
+				step.bodies[i] = bodies[i];
+				step.move_collider(i, transform(i));
+			}
+		}
+	};
+
+	//* static ground under a pile of count unit boxes, columns wide, ground is body 0
+	Scene box_pile(Arena& arena, u32 count, u32 columns = 50) {
+		static auto box = Convex::make(rtf32{ v2f32(-0.5f), v2f32(+0.5f) }, 0);
+		static auto ground = Convex::make(rtf32{ v2f32(-100, -1), v2f32(100, 0) }, 0);
+		auto scene = Scene::create(arena, count + 1);
+		scene.bodies[0] = { .center_mass = v2f32(0), .momentum = {}, .props = { .vec = v4f32(0, 0, 0.2f, 0.6f) } };
+		scene.shapes[0] = &ground;
+		for (auto i : u32xrange{ 0, count }) {
+			scene.bodies[i + 1] = {
+				.center_mass = v2f32(f32(i % columns) * 1.2f - f32(columns) * 0.6f, 1 + f32(i / columns) * 1.2f),
+				.momentum = {},
+				.props = { .vec = v4f32(1, 6, 0.2f, 0.6f) }
+			};
+			scene.shapes[i + 1] = &box;
+		}
+		return scene;
+	}
+
+	//* persistent state of every stage, caches on, sleep off unless asked for
+	//! not movable once ticking, snapshots & options point into it
+	struct Pipeline {
+		FlagMatrix<u32> detections;
+		Broadphase broadphase;
+		GJKCache gjk;
+		ContactCache contacts;
+		Sleep sleep;
+		Solver solver;
+		bool fast_paths = true;
+		JobPool* jobs = null;//* narrowphase & solver run on it when set
+
+		static Pipeline create(Arena* persistent, u32 bodies, Broadphase::Mode broadphase = Broadphase::TREE, Solver::Mode solver = Solver::SEQUENTIAL, bool sleep = false) {
+			auto pipeline = Pipeline{
+				.detections = FlagMatrix<u32>::create_fill(),
+				.broadphase = Broadphase::create(persistent, broadphase, bodies),
+				.gjk = GJKCache::create(persistent, bodies * 4),
+				.contacts = ContactCache::create(persistent, bodies * 4),
+				.sleep = Sleep::create(persistent, bodies),
+				.solver = { .mode = solver, .sequential = {} }
+			};
+			pipeline.sleep.enabled = sleep;
+			return pipeline;
+		}
+
+		NarrowphaseOptions narrowphase() { return { .fast_paths = fast_paths, .gjk = &gjk, .contacts = &contacts }; }
+
+		Array<Manifold> narrow(Arena& arena, SimStep& step) {
+			gjk.next_tick();
+			contacts.next_tick();
+			auto tests = sleep.enabled ? sleep.filter_tests(arena, step.tests.used(), step.bodies.used(), step.colliders.used()) : Array<const NarrowTest>(step.tests.used());
+			return jobs ?
+				query_collisions_parallel(arena, *jobs, tests, step.colliders.used(), narrowphase()) :
+				query_collisions(arena, tests, step.colliders.used(), narrowphase());
+		}
+
+		Array<Manifold> physical(Arena& arena, SimStep& step, Array<const Manifold> manifolds) {
+			auto found = filter_physical(arena, step.bodies.used(), step.colliders.used(), manifolds, detections);
+			if (sleep.enabled)
+				sleep.wake_touched(found, step.bodies.used(), step.colliders.used());
+			return found;
+		}
+
+		Array<Delta> solve(Arena& arena, SimStep& step, Array<const Manifold> physical) {
+			return solver(arena, step.bodies.used(), step.colliders.used(), physical, step.dt, &contacts, jobs);
+		}
+
+		//* resolved bodies back into the scene, sleeping ones lose their momentum
+		void apply(SimStep& step, Array<const Manifold> physical, Array<const Delta> deltas, Scene& scene) {
+			auto resolved = apply_resolution(step.bodies.used(), deltas, { 0, scene.size() });
+			if (sleep.enabled)
+				sleep.update(step.bodies.used(), step.colliders.used(), physical, step.dt);
+			for (auto i : u32xrange{ 0, scene.size() }) {
+				scene.bodies[i] = resolved[i];
+				if (sleep.sleeping(i))
+					scene.bodies[i].momentum = {};
+			}
+		}
+
+		//* narrowphase to resolution on the pairs already in the step
+		Array<Manifold> resolve(Arena& arena, SimStep& step, Scene& scene) {
+			auto manifolds = narrow(arena, step);
+			auto found = physical(arena, step, manifolds);
+			apply(step, found, solve(arena, step, found), scene);
+			return manifolds;
+		}
+
+		//* a whole tick on a fresh step, returns the state hash of the bodies after it
+		u64 tick(Arena& step_arena, Scene& scene, f32 dt) {
+			step_arena.reset();
+			auto step = SimStep::create(&step_arena, dt, scene.size(), scene.size());
+			scene.integrate(dt, sleep);
+			scene.submit(step);
+			broadphase(step, detections);
+			resolve(step_arena, step, scene);
+			return state_hash(scene.bodies);
+		}
+	};
+
+}
+
+#endif
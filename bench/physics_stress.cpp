@@ -0,0 +1,235 @@
+#ifndef GPHYSICS_STRESS
+# define GPHYSICS_STRESS
+
+//* Headless physics stress test -> `make stress && ./build/physics_stress -ticks 600 -circle 500`
+//* loads a tilemap's terrain, drops a configurable number of bodies of every Convex type on it & runs the full pipeline,
+//* reports the cost of each stage, how many pairs went through it & how much the step arena handed out
+
+#include <blblstd.hpp>
+#include <math.cpp>
+#include <time.cpp>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <physics_2d.cpp>
+#include <tilemap_terrain.cpp>
+#include <physics_scene.cpp>
+
+namespace Stress {
+	using namespace Physics2D;
+	using namespace Bench;
+
+	struct Config {
+		cstrp map = "test_stuff/test.tmx";
+		u32 ticks = 600;
+		u32 counts[Convex::SEGMENT + 1] = { 100, 100, 100, 100, 100 };//* per Convex::Type
+		u32 threads = 0;//* 0 for every core, 1 runs the narrowphase & solver serially
+		Solver::Mode solver = Solver::SEQUENTIAL;
+		Broadphase::Mode broadphase = Broadphase::TREE;
+		u32 seed = 1;
+	};
+
+	//* -ticks N -threads N -seed N -map path -solver averaged|sequential -broadphase naive|tree|sap -<type> N, types as in Convex::types
+	bool parse(Config& config, i32 argc, char* argv[]) {
+		auto match = [](cstrp arg, cstrp name) { return arg[0] == '-' && strcasecmp(arg + 1, name) == 0; };
+		for (i32 i = 1; i + 1 < argc; i += 2) {
+			auto arg = argv[i];
+			auto value = argv[i + 1];
+			auto found = false;
+			if (match(arg, "map")) { config.map = value; found = true; }
+			if (match(arg, "ticks")) { config.ticks = u32(atoi(value)); found = true; }
+			if (match(arg, "threads")) { config.threads = u32(atoi(value)); found = true; }
+			if (match(arg, "seed")) { config.seed = u32(atoi(value)); found = true; }
+			if (match(arg, "solver")) for (auto m : u32xrange{ 0, u32(array_size(Solver::modes)) }) if (strcasecmp(value, Solver::modes[m]) == 0) {
+				config.solver = Solver::Mode(m);
+				found = true;
+			}
+			if (match(arg, "broadphase")) for (auto m : u32xrange{ 0, u32(array_size(Broadphase::modes)) }) if (strcasecmp(value, Broadphase::modes[m]) == 0) {
+				config.broadphase = Broadphase::Mode(m);
+				found = true;
+			}
+			for (auto t : u32xrange{ 0, u32(array_size(Convex::types)) }) if (match(arg, Convex::types[t])) {
+				config.counts[t] = u32(atoi(value));
+				found = true;
+			}
+			if (!found) {
+				fprintf(stderr, "Unknown option %s %s\n", arg, value);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//* one shape per Convex::Type, all about a unit wide
+	struct Shapes {
+		v2f32 hexagon[6];
+		v2f32 foci[2];
+		Convex convex[Convex::SEGMENT + 1];
+
+		void init() {
+			for (auto i : u32xrange{ 0, 6 }) {
+				auto angle = glm::two_pi<f32>() * f32(i) / 6.f;
+				hexagon[i] = v2f32(glm::cos(angle), glm::sin(angle)) * 0.5f;
+			}
+			foci[0] = v2f32(0, -0.25f);
+			foci[1] = v2f32(0, +0.25f);
+			convex[Convex::POLYGON] = Convex::make(larray(hexagon), 0);
+			convex[Convex::RECT] = Convex::make(rtf32{ v2f32(-0.5f), v2f32(+0.5f) }, 0);
+			convex[Convex::CAPSULE] = Convex::make(larray(foci), 0.25f);
+			convex[Convex::CIRCLE] = Convex::UNIT_CIRCLE();
+			convex[Convex::SEGMENT] = Convex::make(Segment<v2f32>{ v2f32(-0.5f, 0), v2f32(0.5f, 0) }, 0.05f);
+		}
+	};
+
+	enum Stage : u32 { SUBMIT, BROADPHASE, TERRAIN, NARROWPHASE, FILTER, SOLVE, APPLY, STAGE_COUNT };
+	constexpr cstrp stages[] = { "submit", "broadphase", "terrain_broadphase", "query_collisions", "filter_physical", "solve", "apply_resolution" };
+
+	struct Stats {
+		f64 ms[STAGE_COUNT];
+		f64 max_ms[STAGE_COUNT];
+		u64 tests;
+		u64 terrain_tests;
+		u64 manifolds;
+		u64 physical;
+		u64 step_bytes;
+		u64 max_step_bytes;
+	};
+
+	i32 run(const Config& config) {
+		auto arena = Arena::from_vmem(1ull << 30, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ arena.vmem_release(); };
+		auto terrain_source = Tilemap::load_source(config.map);
+		if (!terrain_source)
+			return 1;
+		auto terrain = Tilemap::Terrain::create(arena, *terrain_source);
+		tmx_map_free(terrain_source);
+		if (terrain.layers.size() == 0) {
+			fprintf(stderr, "%s has no collision layer\n", config.map);
+			return 1;
+		}
+		auto bounds = terrain.layers[0].aabb;
+		u64 pieces = 0;
+		for (auto& layer : terrain.layers) {
+			bounds = bounds | layer.aabb;
+			pieces += layer.baked.size();
+		}
+
+		static Shapes shapes;
+		shapes.init();
+		u32 count = 0;
+		for (auto c : config.counts)
+			count += c;
+
+		//* spawn spots are picked at random in the terrain's bounds, away from its pieces
+		auto terrain_query = Tilemap::TerrainQuery{ terrain };
+		auto rng = u64(config.seed) * 0x9E3779B97F4A7C15ull + 1;
+		auto unit = [&]() {
+			rng ^= rng << 13;
+			rng ^= rng >> 7;
+			rng ^= rng << 17;
+			return f32(rng >> 40) / f32(1 << 24);
+		};
+		auto scene = Scene::create(arena, count);
+		u32 blocked_spawns = 0;
+		for (u32 e = 0; auto type : u32xrange{ 0, u32(array_size(config.counts)) }) for (auto n : u32xrange{ 0, config.counts[type] }) {
+			(void)n;
+			auto spot = v2f32(0);
+			for (auto attempt : u32xrange{ 0, 16 }) {
+				spot = v2f32(lerp(bounds.min.x + 1, bounds.max.x - 1, unit()), lerp(bounds.min.y + 1, bounds.max.y - 1, unit()));
+				auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+				if (query_aabb(scratch, rtf32{ spot - v2f32(0.6f), spot + v2f32(0.6f) }, {}, terrain_query).size() == 0)
+					break;
+				if (attempt == 15)
+					blocked_spawns++;
+			}
+			scene.bodies[e] = { .center_mass = spot, .momentum = {}, .props = { .vec = v4f32(1, 6, 0.2f, 0.6f) } };
+			scene.rotations[e] = unit() * 360;
+			scene.shapes[e++] = &shapes.convex[type];
+		}
+		printf("Terrain %s : %llu layers, %llu baked pieces, bounds (%.1f, %.1f) (%.1f, %.1f)\n",
+			config.map, u64(terrain.layers.size()), pieces, bounds.min.x, bounds.min.y, bounds.max.x, bounds.max.y
+		);
+		printf("Bodies : %u", count);
+		for (auto type : u32xrange{ 0, u32(array_size(config.counts)) })
+			printf(", %u %s", config.counts[type], Convex::types[type]);
+		printf("%s\n", blocked_spawns ? " (some spawned inside the terrain)" : "");
+
+		auto persistent = Arena::from_vmem(1ull << 28, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ persistent.vmem_release(); };
+		auto step_arena = Arena::from_vmem(1ull << 28, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH); defer{ step_arena.vmem_release(); };
+		auto pipeline = Pipeline::create(&persistent, count, config.broadphase, config.solver);
+		static JobPool jobs;
+		if (config.threads != 1)
+			jobs.start(config.threads);
+		if (jobs.worker_count() > 1)
+			pipeline.jobs = &jobs;
+		printf("Broadphase %s, solver %s, %u workers, %u ticks\n", Broadphase::modes[config.broadphase], Solver::modes[config.solver], jobs.worker_count(), config.ticks);
+
+		constexpr f32 dt = 1.f / 60.f;
+		Stats stats = {};
+		auto previous = SimStep::create(&step_arena, dt, count + 1, count + 1);
+		auto run_start = Time::now();
+		for (auto t : u32xrange{ 0, config.ticks }) {
+			(void)t;
+			f64 ms[STAGE_COUNT] = {};
+			auto stage = Time::now();
+			auto lap = [&](Stage s) {
+				auto now = Time::now();
+				ms[s] = Time::duration_cast<Time::t64>(now - stage).count() * 1000.0;
+				stage = now;
+			};
+
+			step_arena.reset();
+			auto step = SimStep::create_like(&step_arena, dt, previous);
+			scene.integrate(dt, pipeline.sleep);
+			scene.submit(step);
+			lap(SUBMIT);
+
+			auto tests = pipeline.broadphase(step, pipeline.detections).size();
+			lap(BROADPHASE);
+			auto terrain_tests = Tilemap::terrain_broadphase(step, terrain, pipeline.detections).size();
+			lap(TERRAIN);
+			auto manifolds = pipeline.narrow(step_arena, step);
+			lap(NARROWPHASE);
+			auto physical = pipeline.physical(step_arena, step, manifolds);
+			lap(FILTER);
+			auto deltas = pipeline.solve(step_arena, step, physical);
+			lap(SOLVE);
+			pipeline.apply(step, physical, deltas, scene);
+			lap(APPLY);
+
+			for (auto s : u32xrange{ 0, STAGE_COUNT }) {
+				stats.ms[s] += ms[s];
+				stats.max_ms[s] = max(stats.max_ms[s], ms[s]);
+			}
+			stats.tests += tests;
+			stats.terrain_tests += terrain_tests;
+			stats.manifolds += manifolds.size();
+			stats.physical += physical.size();
+			stats.step_bytes += u64(step_arena.current);
+			stats.max_step_bytes = max(stats.max_step_bytes, u64(step_arena.current));
+			previous = step;
+		}
+		auto total_ms = Time::duration_cast<Time::t64>(Time::now() - run_start).count() * 1000.0;
+		jobs.stop();
+
+		auto ticks = f64(max(1u, config.ticks));
+		printf("%-20s | %10s | %10s\n", "stage", "ms/tick", "max ms");
+		for (auto s : u32xrange{ 0, STAGE_COUNT })
+			printf("%-20s | %10.4f | %10.4f\n", stages[s], stats.ms[s] / ticks, stats.max_ms[s]);
+		printf("%-20s | %10.4f |\n", "total", total_ms / ticks);
+		printf("Pairs per tick : %.1f broadphase, %.1f terrain, %.1f manifolds, %.1f physical\n",
+			f64(stats.tests) / ticks, f64(stats.terrain_tests) / ticks, f64(stats.manifolds) / ticks, f64(stats.physical) / ticks
+		);
+		printf("Step arena per tick : %.1f kB average, %.1f kB max\n", f64(stats.step_bytes) / ticks / 1024, f64(stats.max_step_bytes) / 1024);
+		return 0;
+	}
+
+}
+
+i32 main(i32 argc, char* argv[]) {
+	auto config = Stress::Config{};
+	if (!Stress::parse(config, argc, argv))
+		return 1;
+	return Stress::run(config);
+}
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef GAABB_TREE
+# define GAABB_TREE
+
+#include <blblstd.hpp>
+#include <math.cpp>
+#include <spall/profiling.cpp>
+
+//* Dynamic AABB tree -> notes/ErinCatto_DynamicBVH_GDC2019.pdf
+//* leaves store fat AABBs so small movements don't need a reinsertion,
+//* sibling search & rotations use the surface area heuristic (perimeter in 2D)
+struct AABBTree {
+	static constexpr i32 NIL = -1;
+
+	struct Node {
+		rtf32 aabb;
+		i32 parent;//* next free node when in the free list
+		i32 children[2];
+		i32 height;//* 0 for leaves, -1 for free nodes
+		u32 item;
+
+		bool is_leaf() const { return height == 0; }
+	};
+
+	Arena* arena;
+	List<Node> nodes;
+	i32 root;
+	i32 free_list;
+	f32 margin;
+
+	static AABBTree create(Arena* arena, u32 expected_items = 256, f32 margin = 0.1f) {
+		return {
+			.arena = arena,
+			.nodes = List{ arena->push_array<Node>(expected_items * 2), 0 },
+			.root = NIL,
+			.free_list = NIL,
+			.margin = margin
+		};
+	}
+
+	static f32 perimeter(rtf32 aabb) { return 2.f * (::width(aabb) + ::height(aabb)); }//* qualified, the height() member hides the free one
+
+	rtf32 fatten(rtf32 aabb) const { return { aabb.min - v2f32(margin), aabb.max + v2f32(margin) }; }
+
+	i32 alloc_node() {
+		if (free_list != NIL) {
+			auto id = free_list;
+			free_list = nodes[id].parent;
+			return id;
+		}
+		auto id = i32(nodes.current);
+		nodes.push_growing(*arena, Node{});
+		return id;
+	}
+
+	void free_node(i32 id) {
+		nodes[id] = {
+			.aabb = {},
+			.parent = free_list,
+			.children = { NIL, NIL },
+			.height = -1,
+			.item = 0
+		};
+		free_list = id;
+	}
+
+	i32 sibling_of(i32 id) const {
+		auto& parent = nodes[nodes[id].parent];
+		return parent.children[parent.children[0] == id ? 1 : 0];
+	}
+
+	void replace_child(i32 parent, i32 old_child, i32 new_child) {
+		if (parent == NIL) {
+			root = new_child;
+		} else {
+			auto& p = nodes[parent];
+			p.children[p.children[0] == old_child ? 0 : 1] = new_child;
+		}
+		nodes[new_child].parent = parent;
+	}
+
+	void refit_node(i32 id) {
+		auto& node = nodes[id];
+		auto& [c0, c1] = node.children;
+		node.aabb = nodes[c0].aabb | nodes[c1].aabb;
+		node.height = 1 + max(nodes[c0].height, nodes[c1].height);
+	}
+
+	//* swaps a child of a with a grandchild from the other side when it lowers the perimeter of the grandchild's parent
+	void rotate(i32 a) {
+		if (nodes[a].height < 2)
+			return;
+		auto [b, c] = nodes[a].children;
+		struct { i32 down, up, parent; f32 delta; } best = { NIL, NIL, NIL, 0 };
+		i32 sides[2][2] = { { b, c }, { c, b } };
+		for (auto& [down, other] : sides) if (!nodes[other].is_leaf()) for (auto i : u32xrange{ 0, 2 }) {
+			auto up = nodes[other].children[i];
+			auto stays = nodes[other].children[1 - i];
+			auto delta = perimeter(nodes[down].aabb | nodes[stays].aabb) - perimeter(nodes[other].aabb);
+			if (delta < best.delta)
+				best = { down, up, other, delta };
+		}
+
+		if (best.down == NIL)
+			return;
+
+		replace_child(best.parent, best.up, best.down);
+		replace_child(a, best.down, best.up);
+		refit_node(best.parent);
+		refit_node(a);
+	}
+
+	void refit_ancestors(i32 id) {
+		for (; id != NIL; id = nodes[id].parent) {
+			refit_node(id);
+			rotate(id);
+		}
+	}
+
+	void insert_leaf(i32 leaf) {
+		if (root == NIL) {
+			root = leaf;
+			nodes[leaf].parent = NIL;
+			return;
+		}
+
+		//* descend towards the cheapest sibling, stop when creating a parent here costs less than going further down
+		auto leaf_aabb = nodes[leaf].aabb;
+		auto sibling = root;
+		while (!nodes[sibling].is_leaf()) {
+			auto& node = nodes[sibling];
+			auto combined = perimeter(node.aabb | leaf_aabb);
+			auto cost = 2.f * combined;
+			auto inheritance_cost = 2.f * (combined - perimeter(node.aabb));
+			f32 child_costs[2];
+			for (auto i : u32xrange{ 0, 2 }) {
+				auto& child = nodes[node.children[i]];
+				auto enlarged = perimeter(child.aabb | leaf_aabb);
+				child_costs[i] = inheritance_cost + (child.is_leaf() ? enlarged : enlarged - perimeter(child.aabb));
+			}
+			if (cost < child_costs[0] && cost < child_costs[1])
+				break;
+			sibling = node.children[child_costs[0] <= child_costs[1] ? 0 : 1];
+		}
+
+		auto old_parent = nodes[sibling].parent;
+		auto new_parent = alloc_node();//! may move nodes, no references held past this point
+		nodes[new_parent] = {
+			.aabb = nodes[sibling].aabb | leaf_aabb,
+			.parent = NIL,
+			.children = { sibling, leaf },
+			.height = nodes[sibling].height + 1,
+			.item = 0
+		};
+		replace_child(old_parent, sibling, new_parent);
+		nodes[sibling].parent = new_parent;
+		nodes[leaf].parent = new_parent;
+		refit_ancestors(old_parent);
+	}
+
+	void remove_leaf(i32 leaf) {
+		if (leaf == root) {
+			root = NIL;
+			return;
+		}
+		auto parent = nodes[leaf].parent;
+		auto grand_parent = nodes[parent].parent;
+		replace_child(grand_parent, parent, sibling_of(leaf));
+		free_node(parent);
+		refit_ancestors(grand_parent);
+	}
+
+	i32 insert(rtf32 aabb, u32 item) {
+		auto leaf = alloc_node();
+		nodes[leaf] = {
+			.aabb = fatten(aabb),
+			.parent = NIL,
+			.children = { NIL, NIL },
+			.height = 0,
+			.item = item
+		};
+		insert_leaf(leaf);
+		return leaf;
+	}
+
+	void remove(i32 leaf) {
+		remove_leaf(leaf);
+		free_node(leaf);
+	}
+
+	//* returns true when the leaf had to be reinserted
+	bool move(i32 leaf, rtf32 aabb) {
+		if (contains(nodes[leaf].aabb, aabb))
+			return false;
+		remove_leaf(leaf);
+		nodes[leaf].aabb = fatten(aabb);
+		insert_leaf(leaf);
+		return true;
+	}
+
+	i32 height() const { return root == NIL ? 0 : nodes[root].height; }
+
+	template<typename F> void query(rtf32 aabb, const F& on_overlap) const {
+		if (root == NIL)
+			return;
+		i32 stack_buffer[height() + 2];
+		auto stack = List{ carray(stack_buffer, height() + 2), 0 };
+		stack.push(root);
+		while (stack.current > 0) {
+			auto& node = nodes[stack.pop()];
+			if (!collide(node.aabb, aabb))
+				continue;
+			if (node.is_leaf()) {
+				on_overlap(node.item);
+			} else {
+				stack.push(node.children[0]);
+				stack.push(node.children[1]);
+			}
+		}
+	}
+
+	//* slab test, does origin + t * displacement cross aabb for some t in [0, 1]
+	static bool crosses(rtf32 aabb, v2f32 origin, v2f32 displacement) {
+		f32 enter = 0, exit = 1;
+		for (auto axis : u32xrange{ 0, 2 }) {
+			if (displacement[axis] == 0) {
+				if (origin[axis] < aabb.min[axis] || origin[axis] > aabb.max[axis])
+					return false;
+				continue;
+			}
+			auto t0 = (aabb.min[axis] - origin[axis]) / displacement[axis];
+			auto t1 = (aabb.max[axis] - origin[axis]) / displacement[axis];
+			enter = max(enter, min(t0, t1));
+			exit = min(exit, max(t0, t1));
+		}
+		return enter <= exit;
+	}
+
+	//* leaves crossed by the segment from origin to origin + displacement
+	template<typename F> void query_ray(v2f32 origin, v2f32 displacement, const F& on_overlap) const {
+		if (root == NIL)
+			return;
+		i32 stack_buffer[height() + 2];
+		auto stack = List{ carray(stack_buffer, height() + 2), 0 };
+		stack.push(root);
+		while (stack.current > 0) {
+			auto& node = nodes[stack.pop()];
+			if (!crosses(node.aabb, origin, displacement))
+				continue;
+			if (node.is_leaf()) {
+				on_overlap(node.item);
+			} else {
+				stack.push(node.children[0]);
+				stack.push(node.children[1]);
+			}
+		}
+	}
+
+	void clear() {
+		nodes.current = 0;
+		root = NIL;
+		free_list = NIL;
+	}
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef GJOBS
+# define GJOBS
+
+#include <blblstd.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <spall/profiling.cpp>
+
+//* Fixed pool of worker threads running parallel loops over chunks, the calling thread takes chunks too
+//* chunks are claimed from an atomic counter so which worker runs which chunk changes from run to run,
+//* jobs must only write to per chunk outputs & merge them in chunk order to stay deterministic
+//! not movable, start the workers once the pool sits at its final address
+struct JobPool {
+	static constexpr u32 MAX_THREADS = 63;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+	std::thread threads[MAX_THREADS];
+	u32 thread_count = 0;
+	u64 generation = 0;
+	u32 busy = 0;
+	bool quit = false;
+
+	//* current job
+	std::atomic<u32> next_chunk = 0;
+	u32 chunk_count = 0;
+	void (*job)(const void* context, u32 chunk, u32 worker) = null;
+	const void* job_context = null;
+
+	~JobPool() { stop(); }
+
+	//* workers counts the calling thread, 0 picks the hardware concurrency
+	void start(u32 workers = 0) {
+		stop();
+		if (workers == 0)
+			workers = max(1u, std::thread::hardware_concurrency());
+		for (auto i : u32xrange{ 0, min(workers - 1, MAX_THREADS) }) {
+			threads[thread_count] = std::thread([this, worker = i + 1]() { worker_loop(worker); });
+			thread_count++;
+		}
+	}
+
+	void stop() {
+		{
+			std::lock_guard lock(mutex);
+			quit = true;
+		}
+		wake.notify_all();
+		for (auto i : u32xrange{ 0, thread_count })
+			threads[i].join();
+		thread_count = 0;
+		quit = false;
+	}
+
+	u32 worker_count() const { return thread_count + 1; }
+
+	void work(u32 worker) {
+		for (u32 chunk; (chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < chunk_count;)
+			job(job_context, chunk, worker);
+	}
+
+	void worker_loop(u32 worker) {
+		PROFILE_THREAD(1024 * 1024);//* scopes profiled inside jobs land on this worker's track
+		u64 seen = 0;
+		for (;;) {
+			{
+				std::unique_lock lock(mutex);
+				wake.wait(lock, [&]() { return quit || generation != seen; });
+				if (quit)
+					return;
+				seen = generation;
+			}
+			work(worker);
+			{
+				std::lock_guard lock(mutex);
+				if (--busy == 0)
+					idle.notify_one();
+			}
+		}
+	}
+
+	//* f(chunk, worker) for every chunk in [0, chunks), worker 0 is the calling thread, returns once every chunk is done
+	template<typename F> void parallel_for(u32 chunks, const F& f) {
+		if (thread_count == 0 || chunks <= 1) {
+			for (auto chunk : u32xrange{ 0, chunks })
+				f(chunk, 0);
+			return;
+		}
+		{
+			std::lock_guard lock(mutex);
+			job = [](const void* context, u32 chunk, u32 worker) { (*(const F*)context)(chunk, worker); };
+			job_context = &f;
+			chunk_count = chunks;
+			next_chunk.store(0, std::memory_order_relaxed);
+			busy = thread_count;
+			generation++;
+		}
+		wake.notify_all();
+		work(0);
+		//* every worker has to check in, none of them may still be reading this job once we return
+		std::unique_lock lock(mutex);
+		idle.wait(lock, [&]() { return busy == 0; });
+	}
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef GPAIR_CACHE
+# define GPAIR_CACHE
+
+#include <blblstd.hpp>
+#include <cstring>
+#include <new>
+
+//* Persistent hash table keyed on pairs of stable ids, lives across ticks
+//* open addressing with linear probing & backward shift deletion, so evictions never leave tombstones behind
+//* entries untouched for more than a given number of ticks are swept
+//! key pairs with a 0 first key are reserved for empty slots
+//! slots are only ever zeroed, memcpy'd or written field by field so their padding stays 0, snapshots copy them raw
+template<typename T> struct PairCache {
+	struct Slot {
+		u64 keys[2];
+		u32 tick;//* last tick this entry was touched
+		T value;
+	};
+
+	Arena* arena;
+	Array<Slot> slots;//* power of 2 size
+	u64 count;
+	u32 tick;
+
+	static Array<Slot> empty_slots(Arena& arena, u64 capacity) {
+		auto slots = arena.push_array<Slot>(capacity);
+		memset(slots.data(), 0, slots.size_bytes());
+		return slots;
+	}
+
+	static PairCache create(Arena* arena, u64 expected_pairs = 256) {
+		u64 capacity = 16;
+		while (capacity < expected_pairs * 2)
+			capacity *= 2;
+		return { arena, empty_slots(*arena, capacity), 0, 0 };
+	}
+
+	//* splitmix64 finalizer over both keys
+	static u64 hash(u64 a, u64 b) {
+		auto h = a * 0x9E3779B97F4A7C15ull ^ (b + 0x632BE59BD9B4E019ull + (a << 6) + (a >> 2));
+		h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+		h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+		return h ^ (h >> 31);
+	}
+
+	u64 mask() const { return slots.size() - 1; }
+	u64 home(const Slot& slot) const { return hash(slot.keys[0], slot.keys[1]) & mask(); }
+	bool empty(u64 i) const { return slots[i].keys[0] == 0; }
+
+	i64 find_slot(u64 a, u64 b) const {
+		for (auto i = hash(a, b) & mask(); !empty(i); i = (i + 1) & mask()) {
+			if (slots[i].keys[0] == a && slots[i].keys[1] == b)
+				return i64(i);
+		}
+		return -1;
+	}
+
+	T* find(u64 a, u64 b) {
+		auto i = find_slot(a, b);
+		if (i < 0)
+			return null;
+		slots[i].tick = tick;
+		return &slots[i].value;
+	}
+
+	//* value initialized when the pair wasn't cached yet
+	T& touch(u64 a, u64 b) {
+		if (auto value = find(a, b))
+			return *value;
+		if ((count + 1) * 2 > slots.size())
+			rehash(slots.size() * 2);
+		auto i = hash(a, b) & mask();
+		while (!empty(i))
+			i = (i + 1) & mask();
+		auto& slot = slots[i];
+		memset(&slot, 0, sizeof(Slot));
+		slot.keys[0] = a;
+		slot.keys[1] = b;
+		slot.tick = tick;
+		new (&slot.value) T{};
+		count++;
+		return slot.value;
+	}
+
+	//* room for that many more pairs without a rehash, pointers to values then stay valid across the next touches
+	void reserve(u64 pairs) {
+		auto capacity = slots.size();
+		while ((count + pairs) * 2 > capacity)
+			capacity *= 2;
+		if (capacity != slots.size())
+			rehash(capacity);
+	}
+
+	void rehash(u64 capacity) {
+		auto old = slots;
+		slots = empty_slots(*arena, capacity);
+		for (auto& slot : old) if (slot.keys[0] != 0) {
+			auto i = home(slot);
+			while (!empty(i))
+				i = (i + 1) & mask();
+			memcpy(&slots[i], &slot, sizeof(Slot));
+		}
+	}
+
+	void remove_at(u64 i) {
+		//* pull back following entries of the cluster unless that would move them before their home slot
+		for (auto j = (i + 1) & mask(); !empty(j); j = (j + 1) & mask()) {
+			auto h = home(slots[j]);
+			auto movable = i <= j ? (h <= i || h > j) : (h <= i && h > j);
+			if (movable) {
+				memcpy(&slots[i], &slots[j], sizeof(Slot));
+				i = j;
+			}
+		}
+		memset(&slots[i], 0, sizeof(Slot));
+		count--;
+	}
+
+	bool remove(u64 a, u64 b) {
+		auto i = find_slot(a, b);
+		if (i < 0)
+			return false;
+		remove_at(u64(i));
+		return true;
+	}
+
+	//* drops entries untouched for more than max_age ticks & starts a new tick, returns the number of evictions
+	u64 next_tick(u32 max_age = 1) {
+		u64 evicted = 0;
+		for (u64 i = 0; i < slots.size();) {
+			if (!empty(i) && tick - slots[i].tick > max_age) {
+				remove_at(i);//* an entry may have been shifted into i, check it again
+				evicted++;
+			} else {
+				i++;
+			}
+		}
+		tick++;
+		return evicted;
+	}
+};
+
+#endif
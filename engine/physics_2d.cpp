@@ -5,16 +5,80 @@
 #include <math.cpp>
 #include <imgui_extension.cpp>
 #include <stdio.h>
+#include <bit>
+#include <algorithm>
 #include <transform.cpp>
 #include <polygon.cpp>
 #include <shape_2d.cpp>
-
+#include <aabb_tree.cpp>
+#include <point_cloud.cpp>
+#include <pair_cache.cpp>
+#include <jobs.cpp>
+
+//* Deterministic mode -> `make DETERMINISTIC=1`, bit identical runs whatever the optimization level or thread count
+//* the physics then only relies on IEEE 754 basic operations evaluated as written, which excludes FMA contraction & fast math,
+//* parallel passes already merge their results in a fixed order & sqrt is correctly rounded, so normalize & length are safe
+//! trig still goes through libm (Transform2D rotations), lockstep peers must run the same libm
+#ifdef PHYSICS_DETERMINISTIC
+# ifdef __FAST_MATH__
+#  error "PHYSICS_DETERMINISTIC is incompatible with -ffast-math"
+# endif
+# ifdef __clang__
+#  pragma STDC FP_CONTRACT OFF
+# endif
+#endif
 
 namespace Physics2D {
 
+#ifdef PHYSICS_DETERMINISTIC
+	constexpr bool DETERMINISTIC = true;
+#else
+	constexpr bool DETERMINISTIC = false;
+#endif
+
+	//* sets bit i of matches when reach & layers[i] != 0, returns the number of layers processed, the remainder is left to the scalar loop
+	//! matches must be zeroed, processed counts are multiples of the lane width so lanes never straddle 2 words
+
+#if defined(__AVX2__)
+
+	inline u64 match_reach_simd(u32 reach, const u32* layers, u64 count, u64* matches) {
+		constexpr u64 W = 8;
+		auto n = count / W * W;
+		auto r = _mm256_set1_epi32(i32(reach));
+		auto zero = _mm256_setzero_si256();
+		for (u64 i = 0; i < n; i += W) {
+			auto missed = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(layers + i)), r), zero);
+			matches[i / 64] |= u64(~_mm256_movemask_ps(_mm256_castsi256_ps(missed)) & 0xFF) << (i % 64);
+		}
+		return n;
+	}
+
+#elif defined(__SSE2__)
+
+	inline u64 match_reach_simd(u32 reach, const u32* layers, u64 count, u64* matches) {
+		constexpr u64 W = 4;
+		auto n = count / W * W;
+		auto r = _mm_set1_epi32(i32(reach));
+		auto zero = _mm_setzero_si128();
+		for (u64 i = 0; i < n; i += W) {
+			auto missed = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i*)(layers + i)), r), zero);
+			matches[i / 64] |= u64(~_mm_movemask_ps(_mm_castsi128_ps(missed)) & 0xF) << (i % 64);
+		}
+		return n;
+	}
+
+#else
+
+	inline u64 match_reach_simd(u32, const u32*, u64, u64*) { return 0; }
+
+#endif
+
 	template<typename T> struct FlagMatrix {
 		static constexpr auto BIT_SIZE = sizeof(T) * 8;
 		T rows[BIT_SIZE];
+		//* rows compiled per byte of a mask, reach_bytes[b][v] is the OR of the rows of the bits set in v when v is the mask's byte b
+		//* kept in sync by set & create_fill, a pair check is then a handful of lookups & an AND instead of a loop over every row
+		T reach_bytes[sizeof(T)][256];
 
 		bool operator[](v2u32 coord) const {
 			return rows[coord.y] & (1 << coord.x);
@@ -22,8 +86,17 @@ namespace Physics2D {
 
 		static T mask_idx(u32 index) { return (T(1) << index); }
 
+		void compile() {
+			for (auto b : u32xrange{ 0, sizeof(T) }) {
+				reach_bytes[b][0] = 0;
+				for (auto v : u32xrange{ 1, 256 })//* v without its lowest bit was compiled already
+					reach_bytes[b][v] = reach_bytes[b][v & (v - 1)] | rows[b * 8 + std::countr_zero(v)];
+			}
+		}
+
 		bool set(u32 row, T xmask, bool value) {
 			rows[row] = (rows[row] & ~(xmask)) | (value ? xmask : 0);
+			compile();
 			return value;
 		}
 
@@ -33,18 +106,42 @@ namespace Physics2D {
 			return set(coord.y, mask_idx(coord.x), value);
 		}
 
+		//* every layer colliding with at least one layer of mask
+		T reach(T mask) const {
+			if (std::has_single_bit(mask))//* colliders mostly sit on a single layer
+				return rows[std::countr_zero(mask)];
+			T r = 0;
+			for (auto b : u32xrange{ 0, sizeof(T) })
+				r |= reach_bytes[b][(mask >> (b * 8)) & 0xFF];
+			return r;
+		}
+
 		bool mask_match(T mask_a, T mask_b) const {
-			for (u32 r = 0; r < BIT_SIZE; r++) {
-				if ((mask_a & mask_idx(r)) && (rows[r] & mask_b))
-					return true;
-			}
-			return false;
+			return (reach(mask_a) & mask_b) != 0;
+		}
+
+		//* one mask against many, bit i of matches is set when mask matches layers[i], returns the number of matches
+		//! matches needs a word per 64 layers
+		u64 match_many(T mask, Array<const T> layers, Array<u64> matches) const {
+			auto r = reach(mask);
+			for (auto& word : matches.subspan(0, (layers.size() + 63) / 64))
+				word = 0;
+			u64 processed = 0;
+			if constexpr (sizeof(T) == sizeof(u32))
+				processed = match_reach_simd(u32(r), (const u32*)layers.data(), layers.size(), matches.data());
+			for (auto i : u64xrange{ processed, layers.size() }) if (r & layers[i])
+				matches[i / 64] |= 1ull << (i % 64);
+			u64 count = 0;
+			for (auto word : matches.subspan(0, (layers.size() + 63) / 64))
+				count += std::popcount(word);
+			return count;
 		}
 
 		static FlagMatrix<T> create_fill(bool value = true) {
 			FlagMatrix<T> fm;
 			for (auto& row : fm.rows)
 				row = value ? T(-1) : 0;
+			fm.compile();
 			return fm;
 		}
 	};
@@ -167,8 +264,14 @@ namespace Physics2D {
 		const Convex* shape;//TODO maybe replace with some sort of ressource handle instead ? invites complexity tho, so maybe keep it a pointer but ensure this is only used as a temporary lifetime struct
 		i32 body_id;
 		u32 layers;
+		CloudSoA world_cloud = {};//* filled by SimStep::push_collider, shape vertices already transformed for this tick
+		u64 uid = 0;//* stable across ticks, keys the per pair caches, 0 opts out of them
+		v2f32 sweep = v2f32(0);//* translation that brought the collider to this pose during the tick, non zero opts in continuous collision
 	};
 
+	//* domain tells apart the systems submitting colliders, key is whatever identifies the collider within it
+	constexpr u64 collider_uid(u16 domain, u64 key) { return (u64(domain) << 48) | (key & ((1ull << 48) - 1)); }
+
 	constexpr i32 NILBODY = -1;
 
 	struct NarrowTest { u32 ids[2]; };
@@ -225,6 +328,44 @@ namespace Physics2D {
 		return { support_verts[iA], support_verts[iB] };
 	}
 
+	//* same as support_circle_cloud over vertices already in world space, the radius offset doesn't depend on the vertex so it is applied once
+	Segment<v2f32> support_world_cloud(const CloudSoA& world_cloud, const m3x3f32& transform, f32 radius, v2f32 norm_dir) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		using namespace glm;
+		v2f32 offset = v2f32(0);
+		if (radius != 0) {
+			v2f32 local_dir = transpose(transform) * v3f32(norm_dir, 0);
+			offset = transform * v3f32(normalize(local_dir) * radius, 0);
+			assert(!glm::any(isnan(offset)));
+		}
+
+		//*iA is best support, iB is either 2nd best support or iA
+		auto [iA, iB] = support_top_two(world_cloud, norm_dir);
+		if (iA < 0)
+			return { v2f32(0), v2f32(0) };
+		return { world_cloud[iA] + offset, world_cloud[iB] + offset };
+	}
+
+	CloudSoA world_cloud(Arena& arena, const Convex& shape, const m3x3f32& transform) {
+		auto to_world = [&](Polygon local) -> CloudSoA {
+			auto cloud = CloudSoA::create(arena, local.size());
+			for (auto i : u64xrange{ 0, local.size() })
+				cloud.set(i, transform * v3f32(local[i], 1));
+			return cloud;
+		};
+		switch (shape.type) {
+		case Convex::POLYGON: return to_world(shape.poly);
+		case Convex::RECT: {
+			auto [v] = QuadGeo::make_vertices<v2f32>(shape.rect);
+			return to_world(larray(v));
+		}
+		case Convex::CAPSULE: return to_world(larray(shape.foci));
+		case Convex::CIRCLE: return to_world(carray(&shape.center, 1));
+		case Convex::SEGMENT: return to_world(carray(&shape.segment.A, 2));
+		default: panic();
+		}
+	}
+
 	template<typename F> concept support_function = requires(const F & f, v2f32 direction) { { f(direction) } -> std::same_as<Segment<v2f32>>; };
 
 	// TODO continuous collision -> support function only selects points from the convex hull, should sample from the convex hull of the shapes at time t & t+dt
@@ -245,6 +386,15 @@ namespace Physics2D {
 			};
 	}
 
+	//* uses the collider's world space vertices cache when it has been pushed to a SimStep
+	inline auto support_function_of(const Collider& collider) {
+		return [&collider](v2f32 direction) -> Segment<v2f32> {
+			if (collider.world_cloud.size() == 0)
+				return support_function_of(*collider.shape, collider.transform)(direction);
+			return support_world_cloud(collider.world_cloud, collider.transform, collider.shape->radius, direction);
+		};
+	}
+
 	rtf32 aabb_segment(const Segment<v2f32>& segment) {
 		return {
 			.min = glm::min(segment.A, segment.B),
@@ -252,16 +402,100 @@ namespace Physics2D {
 		};
 	}
 
+	//* half extents of the aabb of a transformed circle (ellipse), exact
+	inline v2f32 radius_extents(const m3x3f32& transform, f32 radius) {
+		if (radius == 0)
+			return v2f32(0);
+		return radius * v2f32(
+			glm::length(v2f32(transform[0][0], transform[1][0])),
+			glm::length(v2f32(transform[0][1], transform[1][1]))
+		);
+	}
+
+	inline rtf32 aabb_world_cloud(const CloudSoA& world_cloud, v2f32 extents) {
+		rtf32 aabb = { v2f32(xf32::max()), v2f32(xf32::lowest()) };
+		for (auto i : u64xrange{ 0, world_cloud.size() }) {
+			aabb.min = glm::min(aabb.min, world_cloud[i]);
+			aabb.max = glm::max(aabb.max, world_cloud[i]);
+		}
+		return { aabb.min - extents, aabb.max + extents };
+	}
+
+	inline rtf32 aabb_transformed_cloud(Polygon vertices, const m3x3f32& transform, v2f32 extents) {
+		rtf32 aabb = { v2f32(xf32::max()), v2f32(xf32::lowest()) };
+		for (auto v : vertices) {
+			v2f32 world = transform * v3f32(v, 1);
+			aabb.min = glm::min(aabb.min, world);
+			aabb.max = glm::max(aabb.max, world);
+		}
+		return { aabb.min - extents, aabb.max + extents };
+	}
+
+	//* closed form per shape type, single pass over the vertices
 	rtf32 aabb_convex(const Convex& shape, const m3x3f32& transform) {
 		PROFILE_SCOPE(__PRETTY_FUNCTION__);
-		auto b = support_function_of(shape, transform)(v2f32(+0, -1)).A.y;
-		auto t = support_function_of(shape, transform)(v2f32(+0, +1)).A.y;
-		auto l = support_function_of(shape, transform)(v2f32(-1, +0)).A.x;
-		auto r = support_function_of(shape, transform)(v2f32(+1, +0)).A.x;
-		return {
-			.min = v2f32(l, b),
-			.max = v2f32(r, t),
-		};
+		auto extents = radius_extents(transform, shape.radius);
+		switch (shape.type) {
+		case Convex::POLYGON: return aabb_transformed_cloud(shape.poly, transform, extents);
+		case Convex::RECT: {
+			//* transformed center +- absolute linear part applied to the half size
+			v2f32 center = transform * v3f32(shape.rect.center(), 1);
+			auto h = shape.rect.size() / 2.f;
+			auto half = extents + v2f32(
+				glm::abs(transform[0][0]) * h.x + glm::abs(transform[1][0]) * h.y,
+				glm::abs(transform[0][1]) * h.x + glm::abs(transform[1][1]) * h.y
+			);
+			return { center - half, center + half };
+		}
+		case Convex::CAPSULE: return aabb_transformed_cloud(larray(shape.foci), transform, extents);
+		case Convex::CIRCLE: {
+			v2f32 center = transform * v3f32(shape.center, 1);
+			return { center - extents, center + extents };
+		}
+		case Convex::SEGMENT: return aabb_transformed_cloud(carray(&shape.segment.A, 2), transform, extents);
+		default: panic();
+		}
+	}
+
+	//* swept colliders cover their start pose too, the broadphase then catches pairs that crossed during the tick
+	inline rtf32 aabb_collider(const Collider& collider) {
+		auto aabb = collider.world_cloud.size() == 0 ?
+			aabb_convex(*collider.shape, collider.transform) :
+			aabb_world_cloud(collider.world_cloud, radius_extents(collider.transform, collider.shape->radius));
+		if (collider.sweep == v2f32(0))
+			return aabb;
+		return aabb | rtf32{ aabb.min - collider.sweep, aabb.max - collider.sweep };
+	}
+
+	void aabb_colliders(Array<Collider> colliders) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		for (auto& col : colliders)
+			col.aabb = aabb_collider(col);
+	}
+
+	//* offsets v t + a t^2 / 2 reaches for t in [0, duration], per axis the extremes are the ends or the apex of the parabola
+	inline rtf32 trajectory_bounds(v2f32 velocity, v2f32 acceleration, f32 duration) {
+		auto end = velocity * duration + acceleration * (duration * duration * 0.5f);
+		auto bounds = rtf32{ glm::min(v2f32(0), end), glm::max(v2f32(0), end) };
+		for (auto axis : u32xrange{ 0, 2 }) if (acceleration[axis] != 0) {
+			auto t = glm::clamp(-velocity[axis] / acceleration[axis], 0.f, duration);
+			auto apex = velocity[axis] * t + acceleration[axis] * (t * t * 0.5f);
+			bounds.min[axis] = min(bounds.min[axis], apex);
+			bounds.max[axis] = max(bounds.max[axis], apex);
+		}
+		return bounds;
+	}
+
+	//* aabb grown to cover the collider for `duration` from its body's current velocity under a constant acceleration (gravity),
+	//* sub-stepping broadphases a whole frame on these
+	//* spin is covered by how far the aabb's farthest corner can travel around the center of mass
+	//! velocity changes from contacts aren't predictable, margin is all that covers them
+	inline rtf32 reach_aabb(rtf32 aabb, const Body& body, f32 duration, v2f32 acceleration = v2f32(0), f32 margin = 0) {
+		auto travel = trajectory_bounds(body.momentum.velocity, acceleration, duration);
+		auto corner = glm::max(glm::abs(aabb.min - body.center_mass), glm::abs(aabb.max - body.center_mass));
+		auto spin = glm::length(corner) * min(glm::abs(glm::radians(body.momentum.angular_velocity)) * duration, 2.f);//* arc length, capped at the diameter
+		auto grow = v2f32(spin + margin);
+		return { aabb.min + travel.min - grow, aabb.max + travel.max + grow };
 	}
 
 	template<support_function F1, support_function F2> inline v2f32 minkowski_diff_support(
@@ -272,29 +506,49 @@ namespace Physics2D {
 		return f1(+direction).A - f2(-direction).A;
 	}
 
+	//* what GJK needs to jump back to its previous answer on a coherent pair
+	struct GJKWarm {
+		v2f32 directions[3];//* search directions of the terminal simplex when the pair collided, or the separating direction alone
+		u32 count;//* 3 collided, 1 separated, 0 nothing to start from
+	};
+
 	//* Gilbert-Johnson-Keerthi
 	//* https://www.youtube.com/watch?v=ajv46BSqcK4&ab_channel=Reducible
 	template<support_function F1, support_function F2> inline tuple<bool, Triangle> GJK(
 		const F1& f1,
 		const F2& f2,
 		v2f32 start_direction = glm::normalize(v2f32(1)),
-		i32 max_iterations = 999
+		i32 max_iterations = 999,
+		GJKWarm* terminal = null,
+		u32* iterations = null
 	) {
 		using namespace glm;
 		constexpr tuple<bool, Triangle> no_collision = { false, Triangle{} };
 		PROFILE_SCOPE(__PRETTY_FUNCTION__);
 
 		v2f32 triangle_vertices[3];
+		v2f32 search_directions[3];//* direction each vertex of the triangle was found with
 		auto triangle = List{ larray(triangle_vertices), 0 };
+		auto searches = List{ larray(search_directions), 0 };
 		auto direction = start_direction;
 		auto O = v2f32(0);//*origin
 
+		auto finish = [&](i32 i, GJKWarm warm, tuple<bool, Triangle> result) {
+			if (terminal) *terminal = warm;
+			if (iterations) *iterations = u32(i + 1);
+			return result;
+		};
+		auto collided = [&](i32 i) {
+			return finish(i, { { searches[0], searches[1], searches[2] }, 3 }, { true, Triangle::from_array(triangle.used()) });
+		};
+
 		for (auto i = 0; i < max_iterations; i++) {
 			assert(!glm::any(isnan(direction)));
 			auto new_point = minkowski_diff_support(f1, f2, direction);
 			if (dot(new_point, direction) <= 0) //* Did we pass the origin to find A, return early otherwise
-				return no_collision;
+				return finish(i, { { direction }, 1 }, no_collision);
 			triangle.push(new_point);
+			searches.push(direction);
 
 			if (triangle.current == 1) { //* first point case
 				direction = normalize(O - triangle[0]);
@@ -305,7 +559,7 @@ namespace Physics2D {
 				auto ABperp_axis = orthogonal_axis(AB);
 				if (dot(AO, ABperp_axis) == 0) {//* origin is on AB
 					triangle.push(v2f32(0));
-					return { true, Triangle::from_array(triangle.used()) };
+					return finish(i, { {}, 0 }, { true, Triangle::from_array(triangle.used()) });//* not a support point, nothing to warm start from
 				}
 				//* direction should be perpendicular to AB & go towards the origin
 				direction = normalize(ABperp_axis * dot(AO, ABperp_axis));
@@ -317,28 +571,125 @@ namespace Physics2D {
 				auto ABperp_axis = orthogonal_axis(AB);
 				auto ACperp_axis = orthogonal_axis(AC);
 				if (dot(AO, ABperp_axis) == 0) //* origin is on AB
-					return { true, Triangle::from_array(triangle.used()) };
+					return collided(i);
 				if (dot(AO, ACperp_axis) == 0) //* origin is on AC
-					return { true, Triangle::from_array(triangle.used()) };
+					return collided(i);
 				auto ABperp = normalize(ABperp_axis * dot(ABperp_axis, -AC)); //* must go towards the exterior of triangle
 				auto ACperp = normalize(ACperp_axis * dot(ACperp_axis, -AB)); //* must go towards the exterior of triangle
 				if (dot(ABperp, AO) > 0) {//* region AB
 					triangle.remove(0);//*C
+					searches.remove(0);
 					direction = ABperp;
 				} else if (dot(ACperp, AO) > 0) { //* region AC
 					triangle.remove(1);//*B
+					searches.remove(1);
 					direction = ACperp;
 				} else { //* Inside triangle ABC
-					return { true, Triangle::from_array(triangle.used()) };
+					return collided(i);
 				}
 			}
 		}
 
-		return fail_ret("GJK iteration out of bounds", no_collision);
+		return fail_ret("GJK iteration out of bounds", finish(max_iterations - 1, { {}, 0 }, no_collision));
+	}
+
+	//* replays the previous answer first : the old separating direction still separating or the old simplex still enclosing the origin
+	//* costs a single iteration, otherwise GJK resumes from the last search direction
+	//* warm is updated with the new terminal state
+	template<support_function F1, support_function F2> inline tuple<bool, Triangle> GJK_warm(
+		const F1& f1,
+		const F2& f2,
+		GJKWarm& warm,
+		u32& iterations
+	) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		iterations = 1;
+		if (warm.count == 1) {
+			if (glm::dot(minkowski_diff_support(f1, f2, warm.directions[0]), warm.directions[0]) <= 0)
+				return { false, Triangle{} };
+		} else if (warm.count == 3) {
+			Triangle triangle;
+			for (auto i : u32xrange{ 0, 3 })
+				triangle.vertices[i] = minkowski_diff_support(f1, f2, warm.directions[i]);
+			if (intersect_tri_point(larray(triangle.vertices), v2f32(0)))
+				return { true, triangle };
+		} else {
+			iterations = 0;
+		}
+		auto start = warm.count > 0 ? warm.directions[warm.count - 1] : glm::normalize(v2f32(1));
+		u32 cold_iterations = 0;
+		auto result = GJK(f1, f2, start, 999, &warm, &cold_iterations);
+		iterations += cold_iterations;
+		return result;
 	}
 
 	//* Expanding Polytope algorithm
 	//* https://www.youtube.com/watch?v=0XQ2FSz3EK8&ab_channel=Winterdev
+	//* the polytope is a counter clockwise ring of vertices linked by index & its edges wait in a min heap keyed by distance to the origin,
+	//* expanding an edge only ever splits that edge in 2, so the heap never holds stale edges & each iteration is O(log n)
+	struct EPAPolytope {
+		struct Vertex {
+			v2f32 point;
+			u32 next;
+		};
+
+		struct Edge {
+			f32 distance;
+			v2f32 normal;//* outward
+			u32 from;//* edge goes from vertices[from] to vertices[vertices[from].next]
+		};
+
+		List<Vertex> vertices;
+		List<Edge> heap;
+
+		void init(const Triangle& triangle) {
+			auto [a, b, c] = triangle.vertices;
+			auto area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+			if (area < 0)
+				std::swap(b, c);
+			vertices.push({ a, 1 });
+			vertices.push({ b, 2 });
+			vertices.push({ c, 0 });
+			for (auto i : u32xrange{ 0, 3 })
+				push_edge(i);
+		}
+
+		void push_edge(u32 from) {
+			auto a = vertices[from].point;
+			auto d = vertices[vertices[from].next].point - a;
+			if (glm::length2(d) == 0)//* duplicated vertex, no direction to expand towards
+				return;
+			auto normal = glm::normalize(v2f32(d.y, -d.x));
+			auto i = heap.current;
+			heap.push({ glm::dot(normal, a), normal, from });
+			for (; i > 0 && heap[(i - 1) / 2].distance > heap[i].distance; i = (i - 1) / 2)
+				std::swap(heap[i], heap[(i - 1) / 2]);
+		}
+
+		Edge pop_edge() {
+			auto top = heap[0];
+			heap[0] = heap.pop();
+			for (u64 i = 0;;) {
+				auto smallest = i;
+				for (auto child : { 2 * i + 1, 2 * i + 2 }) if (child < heap.current && heap[child].distance < heap[smallest].distance)
+					smallest = child;
+				if (smallest == i)
+					break;
+				std::swap(heap[i], heap[smallest]);
+				i = smallest;
+			}
+			return top;
+		}
+
+		void split(u32 from, v2f32 point) {
+			auto id = u32(vertices.current);
+			vertices.push({ point, vertices[from].next });
+			vertices[from].next = id;
+			push_edge(from);
+			push_edge(id);
+		}
+	};
+
 	template<support_function F1, support_function F2> v2f32 EPA(
 		const F1& f1,
 		const F2& f2,
@@ -349,67 +700,56 @@ namespace Physics2D {
 		using namespace glm;
 		PROFILE_SCOPE(__PRETTY_FUNCTION__);
 
-		v2f32 points_buffer[max_iteration + 3];
-		auto points = List{ carray(points_buffer, max_iteration + 3), 0 };
-		points.push(larray(triangle.vertices));
-
-		auto best_point_index = 0;
-		while (max_iteration-- > 0) {
-			auto O = average(points.used());
-			struct {
-				f32 distance_to_origin = std::numeric_limits<f32>::max();
-				v2f32 normal = v2f32(0);
-				u64 pindex = 0;
-			} closest_seg;
-
-			for (auto i : u64xrange{ 0, points.current }) {//* find edge closest to origin
-				auto j = (i + 1) % points.current;
-				auto seg = Segment{ points[i], points[j] };
-				auto OA = seg.A - O;
-				auto normal_axis = orthogonal_axis(direction(seg));
-				auto side = sign(dot(normal_axis, OA));
-				if (side == 0) {//* handle flat triangle
-					closest_seg = {
-						0,
-						normalize(normal_axis),
-						j//* using j so that the inserted point will be between i and j
-					};
-				} else {
-					v2f32 normal = normalize(side * normal_axis);
-					assert(!glm::any(glm::isnan(normal)));
-					auto dist_to_ori = abs(dot(normal, seg.A));
-
-					if (dist_to_ori < closest_seg.distance_to_origin) {
-						closest_seg = {
-							dist_to_ori,
-							normal,
-							j//* using j so that the inserted point will be between i and j
-						};
-					}
-				}
-			}
+		//* each iteration adds 1 vertex & replaces 1 edge with 2
+		EPAPolytope::Vertex vertices_buffer[max_iteration + 3];
+		EPAPolytope::Edge edges_buffer[max_iteration + 3];
+		auto polytope = EPAPolytope{
+			.vertices = List{ carray(vertices_buffer, max_iteration + 3), 0 },
+			.heap = List{ carray(edges_buffer, max_iteration + 3), 0 }
+		};
+		polytope.init(triangle);
 
-			auto support_point = minkowski_diff_support(f1, f2, closest_seg.normal);
-			auto error = dot(closest_seg.normal, support_point) - closest_seg.distance_to_origin;
+		while (max_iteration-- > 0 && polytope.heap.current > 0) {
+			auto closest = polytope.pop_edge();
+			auto support_point = minkowski_diff_support(f1, f2, closest.normal);
+			auto error = dot(closest.normal, support_point) - closest.distance;
 
 			if (error <= precision_threshold) //* new point is close enough
-				return closest_seg.normal * closest_seg.distance_to_origin;
-			else
-				points.insert_ordered(best_point_index = closest_seg.pindex, support_point);//* slow af, might want to replace array list ? but we need ordered specifically for indexed access, so linked list would be slow too (unless maybe if we use ptr instead of index, replace (i, j) with (node, node->next))
+				return closest.normal * closest.distance;
+			polytope.split(closest.from, support_point);
 		}
-		return points[best_point_index];
+		if (polytope.heap.current == 0)
+			return v2f32(0);
+		return polytope.heap[0].normal * polytope.heap[0].distance;//* out of iterations, best estimate so far
 	}
 
 	f32 cross_2(v2f32 a, v2f32 b) {
 		return glm::cross(v3f32(a, 0), v3f32(b, 0)).z;
 	}
 
+	template<support_function F1, support_function F2> Contact make_contact(const F1& f1, const F2& f2, v2f32 penetration) {
+		auto contact_dir = v2f32(normalize(v2f64(penetration)));
+
+		Contact ctc = {
+			.penetration = penetration,
+			.supports = { f1(+contact_dir), f2(-contact_dir) },
+			.aabb = {}
+		};
+		ctc.aabb = aabb_segment(ctc.supports[0]) & aabb_segment(ctc.supports[1]);
+		return ctc;
+	}
+
 	template<support_function F1, support_function F2> tuple<bool, Contact> intersect_convex(
 		F1 f1, F2 f2,
-		f32 penetration_tolerance = 0
+		f32 penetration_tolerance = 0,
+		GJKWarm* warm = null,
+		u32* gjk_iterations = null
 	) {
 		PROFILE_SCOPE(__PRETTY_FUNCTION__);
-		auto [collided, triangle] = GJK(f1, f2);
+		u32 iterations = 0;
+		auto [collided, triangle] = warm ? GJK_warm(f1, f2, *warm, iterations) : GJK(f1, f2, glm::normalize(v2f32(1)), 999, null, &iterations);
+		if (gjk_iterations)
+			*gjk_iterations = iterations;
 
 		if (!collided)
 			return { false, Contact{} };
@@ -419,15 +759,497 @@ namespace Physics2D {
 		if (length2(penetration) <= penetration_tolerance)
 			return { false, Contact{} };
 
-		auto contact_dir = v2f32(normalize(v2f64(penetration)));
+		return { collided, make_contact(f1, f2, penetration) };
+	}
 
-		Contact ctc = {
-			.penetration = penetration,
-			.supports = { f1(+contact_dir), f2(-contact_dir) },
-			.aabb = {}
+	//* Closed form & SAT penetration for the common shape pairs, only the penetration is computed here,
+	//* contacts are then built from the support functions exactly like after EPA
+	//* penetration follows the EPA convention : from collider 0 towards collider 1, moving 0 by -penetration separates them
+	namespace Analytic {
+		enum Result : u8 { FALLBACK, SEPARATED, PENETRATING };
+
+		constexpr f32 EPSILON = 1e-5f;
+
+		//* CIRCLE, CAPSULE & SEGMENT in world space, A == B for circles
+		struct Rounded {
+			Segment<v2f32> core;
+			f32 radius;
 		};
-		ctc.aabb = aabb_segment(ctc.supports[0]) & aabb_segment(ctc.supports[1]);
-		return { collided, ctc };
+
+		//* RECT in world space, axes are normalized
+		struct Box {
+			v2f32 center;
+			v2f32 axes[2];
+			v2f32 half;
+			f32 radius;
+
+			v2f32 corner(u32 i) const { return center + axes[0] * (i & 1 ? +half.x : -half.x) + axes[1] * (i & 2 ? +half.y : -half.y); }
+		};
+
+		struct Interval { f32 min, max; };
+
+		//* a rounded shape only stays rounded under rotation + uniform scale
+		inline bool keeps_radius(const m3x3f32& transform, f32 radius) {
+			if (radius == 0)
+				return true;
+			v2f32 c0 = transform[0], c1 = transform[1];
+			auto l0 = glm::length(c0), l1 = glm::length(c1);
+			return glm::abs(l0 - l1) <= EPSILON * l0 && glm::abs(glm::dot(c0, c1)) <= EPSILON * l0 * l1;
+		}
+
+		tuple<bool, Rounded> rounded_of(const Collider& collider) {
+			auto& shape = *collider.shape;
+			auto& transform = collider.transform;
+			if (!keeps_radius(transform, shape.radius))
+				return { false, {} };
+			auto to_world = [&](v2f32 p) -> v2f32 { return transform * v3f32(p, 1); };
+			auto radius = shape.radius * glm::length(v2f32(transform[0]));
+			switch (shape.type) {
+			case Convex::CIRCLE: return { true, { { to_world(shape.center), to_world(shape.center) }, radius } };
+			case Convex::CAPSULE: return { true, { { to_world(shape.foci[0]), to_world(shape.foci[1]) }, radius } };
+			case Convex::SEGMENT: return { true, { { to_world(shape.segment.A), to_world(shape.segment.B) }, radius } };
+			default: return { false, {} };
+			}
+		}
+
+		//* sheared rects aren't boxes anymore
+		tuple<bool, Box> box_of(const Collider& collider) {
+			auto& shape = *collider.shape;
+			auto& transform = collider.transform;
+			if (shape.type != Convex::RECT)
+				return { false, {} };
+			v2f32 c0 = transform[0], c1 = transform[1];
+			auto l0 = glm::length(c0), l1 = glm::length(c1);
+			if (l0 == 0 || l1 == 0 || glm::abs(glm::dot(c0, c1)) > EPSILON * l0 * l1 || !keeps_radius(transform, shape.radius))
+				return { false, {} };
+			return { true, {
+				.center = transform * v3f32(shape.rect.center(), 1),
+				.axes = { c0 / l0, c1 / l1 },
+				.half = glm::abs(shape.rect.size()) / 2.f * v2f32(l0, l1),
+				.radius = shape.radius * l0
+			} };
+		}
+
+		inline Interval project(const Segment<v2f32>& segment, v2f32 axis) {
+			auto a = glm::dot(segment.A, axis), b = glm::dot(segment.B, axis);
+			return { min(a, b), max(a, b) };
+		}
+
+		inline Interval project(const Box& box, v2f32 axis) {
+			auto c = glm::dot(box.center, axis);
+			auto r = box.half.x * glm::abs(glm::dot(box.axes[0], axis)) + box.half.y * glm::abs(glm::dot(box.axes[1], axis));
+			return { c - r, c + r };
+		}
+
+		//* separating axis test over the cores, keeps the smallest push of shape 0 out of shape 1
+		struct SAT {
+			f32 depth = xf32::max();
+			v2f32 direction = v2f32(0);
+			bool separated = false;
+
+			void test(Interval a, Interval b, v2f32 axis) {
+				auto forward = a.max - b.min;//* push a along -axis
+				auto backward = b.max - a.min;//* push a along +axis
+				if (forward <= 0 || backward <= 0) {
+					separated = true;
+					return;
+				}
+				if (forward < depth) {
+					depth = forward;
+					direction = +axis;
+				}
+				if (backward < depth) {
+					depth = backward;
+					direction = -axis;
+				}
+			}
+		};
+
+		inline v2f32 closest_on_segment(const Segment<v2f32>& segment, v2f32 p) {
+			auto d = segment.B - segment.A;
+			auto l2 = glm::length2(d);
+			if (l2 == 0)
+				return segment.A;
+			return segment.A + d * glm::clamp(glm::dot(p - segment.A, d) / l2, 0.f, 1.f);
+		}
+
+		inline v2f32 closest_on_box(const Box& box, v2f32 p) {
+			auto local = p - box.center;
+			return box.center +
+				box.axes[0] * glm::clamp(glm::dot(local, box.axes[0]), -box.half.x, +box.half.x) +
+				box.axes[1] * glm::clamp(glm::dot(local, box.axes[1]), -box.half.y, +box.half.y);
+		}
+
+		//* Real-Time Collision Detection, Ericson, 5.1.9
+		tuple<v2f32, v2f32> closest_points(const Segment<v2f32>& s0, const Segment<v2f32>& s1) {
+			auto d0 = s0.B - s0.A;
+			auto d1 = s1.B - s1.A;
+			auto r = s0.A - s1.A;
+			auto a = glm::dot(d0, d0);
+			auto e = glm::dot(d1, d1);
+			auto f = glm::dot(d1, r);
+			f32 s = 0, t = 0;
+			if (a == 0 && e == 0)
+				return { s0.A, s1.A };
+			if (a == 0) {
+				t = glm::clamp(f / e, 0.f, 1.f);
+			} else {
+				auto c = glm::dot(d0, r);
+				if (e == 0) {
+					s = glm::clamp(-c / a, 0.f, 1.f);
+				} else {
+					auto b = glm::dot(d0, d1);
+					auto denom = a * e - b * b;
+					s = denom != 0 ? glm::clamp((b * f - c * e) / denom, 0.f, 1.f) : 0.f;
+					t = (b * s + f) / e;
+					if (t < 0) {
+						t = 0;
+						s = glm::clamp(-c / a, 0.f, 1.f);
+					} else if (t > 1) {
+						t = 1;
+						s = glm::clamp((b - c) / a, 0.f, 1.f);
+					}
+				}
+			}
+			return { s0.A + d0 * s, s1.A + d1 * t };
+		}
+
+		//* disjoint cores, rounded shapes penetrate along the line between the closest points
+		inline Result from_closest(v2f32 p0, v2f32 p1, f32 radius, v2f32& penetration) {
+			auto d = p1 - p0;
+			auto distance = glm::length(d);
+			if (distance <= EPSILON)//* touching cores, no stable normal
+				return FALLBACK;
+			if (radius <= distance)
+				return SEPARATED;
+			penetration = d / distance * (radius - distance);
+			return PENETRATING;
+		}
+
+		Result rounded_rounded(const Rounded& r0, const Rounded& r1, v2f32& penetration) {
+			auto [p0, p1] = closest_points(r0.core, r1.core);
+			return from_closest(p0, p1, r0.radius + r1.radius, penetration);
+		}
+
+		Result rounded_box(const Rounded& r, const Box& box, v2f32& penetration) {
+			auto sat = SAT{};
+			for (auto axis : box.axes)
+				sat.test(project(r.core, axis), project(box, axis), axis);
+			if (auto d = r.core.B - r.core.A; glm::length2(d) > 0) {
+				auto normal = glm::normalize(orthogonal_axis(d));
+				sat.test(project(r.core, normal), project(box, normal), normal);
+			}
+			if (!sat.separated) {
+				penetration = sat.direction * (sat.depth + r.radius + box.radius);
+				return PENETRATING;
+			}
+			if (r.radius + box.radius == 0)
+				return SEPARATED;
+
+			//* disjoint convex cores, the closest pair always involves a vertex of one of them
+			struct { v2f32 p0, p1; f32 d2; } closest = { v2f32(0), v2f32(0), xf32::max() };
+			auto keep = [&](v2f32 p0, v2f32 p1) { if (auto d2 = glm::length2(p1 - p0); d2 < closest.d2) closest = { p0, p1, d2 }; };
+			for (auto p : { r.core.A, r.core.B })
+				keep(p, closest_on_box(box, p));
+			for (auto i : u32xrange{ 0, 4 })
+				keep(closest_on_segment(r.core, box.corner(i)), box.corner(i));
+			return from_closest(closest.p0, closest.p1, r.radius + box.radius, penetration);
+		}
+
+		Result box_box(const Box& b0, const Box& b1, v2f32& penetration) {
+			auto sat = SAT{};
+			for (auto axis : b0.axes)
+				sat.test(project(b0, axis), project(b1, axis), axis);
+			for (auto axis : b1.axes)
+				sat.test(project(b0, axis), project(b1, axis), axis);
+			if (!sat.separated) {
+				penetration = sat.direction * (sat.depth + b0.radius + b1.radius);
+				return PENETRATING;
+			}
+			if (b0.radius + b1.radius == 0)
+				return SEPARATED;
+
+			struct { v2f32 p0, p1; f32 d2; } closest = { v2f32(0), v2f32(0), xf32::max() };
+			auto keep = [&](v2f32 p0, v2f32 p1) { if (auto d2 = glm::length2(p1 - p0); d2 < closest.d2) closest = { p0, p1, d2 }; };
+			for (auto i : u32xrange{ 0, 4 }) {
+				keep(b0.corner(i), closest_on_box(b1, b0.corner(i)));
+				keep(closest_on_box(b0, b1.corner(i)), b1.corner(i));
+			}
+			return from_closest(closest.p0, closest.p1, b0.radius + b1.radius, penetration);
+		}
+
+		using Test = Result(*)(const Collider&, const Collider&, v2f32&);
+
+		Result test_rounded_rounded(const Collider& c0, const Collider& c1, v2f32& penetration) {
+			auto [ok0, r0] = rounded_of(c0);
+			auto [ok1, r1] = rounded_of(c1);
+			return ok0 && ok1 ? rounded_rounded(r0, r1, penetration) : FALLBACK;
+		}
+
+		Result test_rounded_box(const Collider& c0, const Collider& c1, v2f32& penetration) {
+			auto [ok0, r] = rounded_of(c0);
+			auto [ok1, box] = box_of(c1);
+			return ok0 && ok1 ? rounded_box(r, box, penetration) : FALLBACK;
+		}
+
+		Result test_box_rounded(const Collider& c0, const Collider& c1, v2f32& penetration) {
+			auto result = test_rounded_box(c1, c0, penetration);
+			penetration = -penetration;
+			return result;
+		}
+
+		Result test_box_box(const Collider& c0, const Collider& c1, v2f32& penetration) {
+			auto [ok0, b0] = box_of(c0);
+			auto [ok1, b1] = box_of(c1);
+			return ok0 && ok1 ? box_box(b0, b1, penetration) : FALLBACK;
+		}
+
+		//* indexed by [Convex::Type][Convex::Type], null entries go through GJK/EPA
+		constexpr Test dispatch[5][5] = {
+			//* POLYGON          RECT                 CAPSULE               CIRCLE                SEGMENT
+			{ null,              null,                null,                 null,                 null },//* POLYGON
+			{ null,              test_box_box,        test_box_rounded,     test_box_rounded,     test_box_rounded },//* RECT
+			{ null,              test_rounded_box,    test_rounded_rounded, test_rounded_rounded, test_rounded_rounded },//* CAPSULE
+			{ null,              test_rounded_box,    test_rounded_rounded, test_rounded_rounded, test_rounded_rounded },//* CIRCLE
+			{ null,              test_rounded_box,    test_rounded_rounded, test_rounded_rounded, test_rounded_rounded },//* SEGMENT
+		};
+	}
+
+	//* Per pair GJK warm start data carried across ticks, keyed on collider uids
+	struct GJKCache {
+		static constexpr u32 HISTOGRAM_SIZE = 8;
+
+		PairCache<GJKWarm> seeds;
+		struct Stats {
+			u64 queries;
+			u64 warm_hits;//* answered by replaying the previous tick's state
+			u64 iterations;
+			u64 histogram[HISTOGRAM_SIZE];//* queries per iteration count, the last bucket takes everything above
+
+			void record(u32 count, bool warm_hit) {
+				queries++;
+				iterations += count;
+				warm_hits += warm_hit ? 1 : 0;
+				histogram[min(count, HISTOGRAM_SIZE) - 1]++;
+			}
+
+			void merge(const Stats& other) {
+				queries += other.queries;
+				warm_hits += other.warm_hits;
+				iterations += other.iterations;
+				for (auto i : u32xrange{ 0, HISTOGRAM_SIZE })
+					histogram[i] += other.histogram[i];
+			}
+		} stats;
+
+		static GJKCache create(Arena* arena, u32 expected_pairs = 256) {
+			return { PairCache<GJKWarm>::create(arena, expected_pairs), {} };
+		}
+
+		//* pairs are stored with their lowest uid first, the minkowski difference of the swapped pair is mirrored so are its directions
+		GJKWarm* seed(const Collider& c0, const Collider& c1) {
+			if (c0.uid == 0 || c1.uid == 0)
+				return null;
+			return &(c0.uid < c1.uid ? seeds.touch(c0.uid, c1.uid) : seeds.touch(c1.uid, c0.uid));
+		}
+
+		//* marks the pair's seed as used this tick without creating it, for pairs whose contact got reused instead of running GJK
+		void keep(const Collider& c0, const Collider& c1) {
+			if (c0.uid != 0 && c1.uid != 0)
+				c0.uid < c1.uid ? seeds.find(c0.uid, c1.uid) : seeds.find(c1.uid, c0.uid);
+		}
+
+
+		void next_tick() {
+			seeds.next_tick();
+			stats = {};
+		}
+	};
+
+	inline void mirror(GJKWarm& warm) {
+		for (auto i : u32xrange{ 0, warm.count })
+			warm.directions[i] = -warm.directions[i];
+	}
+
+	//* analytic fast path when the pair has one, GJK/EPA otherwise
+	//* warm is the pair's GJKCache seed, stored lowest uid first, only the pair's own entry is written so pairs can run concurrently
+	//* Continuous collision -> conservative advancement (Mirtich) along the colliders' sweeps, translation only, rotation over the tick is ignored
+	//* distances come from GJK on the Minkowski difference B - A, simplex vertices keep the supports they came from to recover the closest points
+	struct Separation {
+		f32 distance;//* 0 when overlapping
+		v2f32 normal;//* from collider 0 toward collider 1
+		v2f32 witnesses[2];//* closest point on each collider
+	};
+
+	template<support_function F1, support_function F2> Separation separation(const F1& f1, const F2& f2, u32 max_iterations = 32, f32 tolerance = 1e-5f) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		using namespace glm;
+		struct Vertex { v2f32 a, b, w; };
+		auto support = [&](v2f32 direction) -> Vertex {
+			auto a = f1(-direction).A;
+			auto b = f2(+direction).A;
+			return { a, b, b - a };
+		};
+
+		Vertex simplex[3] = { support(v2f32(1, 0)) };
+		f32 weights[3] = { 1, 0, 0 };
+		u32 count = 1;
+		auto closest = simplex[0].w;
+		auto overlapping = false;
+		//* keeps the simplex to the feature of [p, q] closest to the origin
+		auto reduce_segment = [&](u32 p, u32 q) -> v2f32 {
+			auto e = simplex[q].w - simplex[p].w;
+			auto l = length2(e);
+			auto t = l > 0 ? clamp(-dot(simplex[p].w, e) / l, 0.f, 1.f) : 0.f;
+			Vertex vp = simplex[p], vq = simplex[q];
+			if (t <= 0) { simplex[0] = vp; weights[0] = 1; count = 1; }
+			else if (t >= 1) { simplex[0] = vq; weights[0] = 1; count = 1; }
+			else { simplex[0] = vp; simplex[1] = vq; weights[0] = 1 - t; weights[1] = t; count = 2; }
+			return vp.w + e * t;
+		};
+
+		for (auto it : u32xrange{ 0, max_iterations }) {
+			(void)it;
+			if (length2(closest) <= tolerance * tolerance) {
+				overlapping = true;
+				break;
+			}
+			auto w = support(normalize(-closest));
+			//* no progress toward the origin, closest is the minimum
+			if (length2(closest) - dot(closest, w.w) <= tolerance * length2(closest))
+				break;
+			auto repeated = false;
+			for (auto i : u32xrange{ 0, count })
+				repeated |= simplex[i].w == w.w;
+			if (repeated)
+				break;
+			simplex[count++] = w;
+			if (count == 2) {
+				closest = reduce_segment(0, 1);
+				continue;
+			}
+			auto area = cross_2(simplex[1].w - simplex[0].w, simplex[2].w - simplex[0].w);
+			auto inside = area != 0 &&
+				cross_2(simplex[1].w - simplex[0].w, -simplex[0].w) * area >= 0 &&
+				cross_2(simplex[2].w - simplex[1].w, -simplex[1].w) * area >= 0 &&
+				cross_2(simplex[0].w - simplex[2].w, -simplex[2].w) * area >= 0;
+			if (inside) {
+				overlapping = true;
+				break;
+			}
+			//* closest of the 3 edges
+			u32 edges[3][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
+			struct { f32 distance; u32 edge; } best = { xf32::max(), 0 };
+			for (auto e : u32xrange{ 0, 3 }) {
+				auto d = simplex[edges[e][1]].w - simplex[edges[e][0]].w;
+				auto l = length2(d);
+				auto t = l > 0 ? clamp(-dot(simplex[edges[e][0]].w, d) / l, 0.f, 1.f) : 0.f;
+				auto distance = length2(simplex[edges[e][0]].w + d * t);
+				if (distance < best.distance)
+					best = { distance, e };
+			}
+			closest = reduce_segment(edges[best.edge][0], edges[best.edge][1]);
+		}
+
+		Separation result = { 0, v2f32(0), { v2f32(0), v2f32(0) } };
+		for (auto i : u32xrange{ 0, count }) {
+			result.witnesses[0] += simplex[i].a * weights[i];
+			result.witnesses[1] += simplex[i].b * weights[i];
+		}
+		if (!overlapping) {
+			result.distance = length(closest);
+			result.normal = closest / result.distance;
+		}
+		return result;
+	}
+
+	struct Impact {
+		enum Kind : u32 { MISSED, STARTS_OVERLAPPING, HIT } kind;
+		f32 time;//* fraction of the tick
+		Separation separation;//* at time, relative to collider 0's end pose
+	};
+
+	//* f0 & f1 support the end poses, the sweeps are the translations that brought them there,
+	//* time advances by the distance over the approach speed so the shapes can't cross each other, until they are closer than target
+	template<support_function F1, support_function F2> Impact time_of_impact(const F1& f0, const F2& f1, v2f32 sweep0, v2f32 sweep1, f32 target = 1e-3f, u32 max_iterations = 20) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		auto relative = sweep1 - sweep0;//* motion of 1 relative to 0 over the tick
+		f32 t = 0;
+		Separation sep = {};
+		for (auto it : u32xrange{ 0, max_iterations }) {
+			auto back = relative * (t - 1);//* 1 at time t, 0 held at its end pose
+			sep = separation(f0, [&](v2f32 direction) -> Segment<v2f32> { auto s = f1(direction); return { s.A + back, s.B + back }; });
+			if (sep.distance == 0)
+				return { it == 0 ? Impact::STARTS_OVERLAPPING : Impact::HIT, t, sep };
+			if (sep.distance <= target)
+				return { Impact::HIT, t, sep };
+			auto approach = -glm::dot(relative, sep.normal);
+			if (approach <= 0)
+				return { Impact::MISSED, 1, sep };
+			t += (sep.distance - target * 0.5f) / approach;
+			if (t >= 1)
+				return { Impact::MISSED, 1, sep };
+		}
+		return { Impact::HIT, t, sep };//* still closing in, stopping early is the conservative answer
+	}
+
+	//* contact for a pair that met during the tick, its penetration pushes them back to where they met along the impact normal
+	//* the contact point is the faster collider's touching point carried to its end pose, exact against static colliders
+	tuple<bool, Contact> swept_contact(const Impact& impact, v2f32 sweep0, v2f32 sweep1) {
+		auto relative = sweep1 - sweep0;
+		auto& sep = impact.separation;
+		auto depth = -glm::dot(relative, sep.normal) * (1 - impact.time) - sep.distance;
+		if (depth <= 0)
+			return { false, Contact{} };
+		v2f32 touching[] = { sep.witnesses[0], sep.witnesses[1] - relative * (impact.time - 1) };
+		auto point = touching[glm::length2(sweep1) >= glm::length2(sweep0) ? 1 : 0];
+		return { true, Contact{
+			.penetration = sep.normal * depth,
+			.supports = { { touching[0], touching[0] }, { touching[1], touching[1] } },
+			.aabb = { point, point }
+		} };
+	}
+
+	tuple<bool, Contact> intersect_colliders(const Collider& c0, const Collider& c1, f32 penetration_tolerance, bool fast_paths, GJKWarm* warm, GJKCache::Stats* gjk_stats) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		auto f0 = support_function_of(c0);
+		auto f1 = support_function_of(c1);
+		//* pairs already overlapping at the start of the tick or that never met go through the discrete tests
+		if (c0.sweep != c1.sweep) {
+			auto impact = time_of_impact(f0, f1, c0.sweep, c1.sweep);
+			if (impact.kind == Impact::HIT && impact.time > 0) if (auto [hit, contact] = swept_contact(impact, c0.sweep, c1.sweep); hit)
+				return { true, contact };
+		}
+		if (auto test = fast_paths ? Analytic::dispatch[c0.shape->type][c1.shape->type] : null) {
+			v2f32 penetration = v2f32(0);
+			switch (test(c0, c1, penetration)) {
+			case Analytic::SEPARATED: return { false, Contact{} };
+			case Analytic::PENETRATING: {
+				if (length2(penetration) <= penetration_tolerance)
+					return { false, Contact{} };
+				return { true, make_contact(f0, f1, penetration) };
+			}
+			case Analytic::FALLBACK: break;
+			}
+		}
+		if (!warm)
+			return intersect_convex(f0, f1, penetration_tolerance);
+
+		auto swapped = c1.uid < c0.uid;
+		if (swapped) mirror(*warm);
+		auto replayable = warm->count > 0;
+		u32 iterations = 0;
+		auto result = intersect_convex(f0, f1, penetration_tolerance, warm, &iterations);
+		if (swapped) mirror(*warm);
+		if (gjk_stats)
+			gjk_stats->record(iterations, replayable && iterations == 1);
+		return result;
+	}
+
+	//* the seed is resolved even when a fast path answers, the cache ends up the same whatever the pair needed
+	tuple<bool, Contact> intersect_colliders(const Collider& c0, const Collider& c1, f32 penetration_tolerance = 0, bool fast_paths = true, GJKCache* gjk_cache = null) {
+		auto warm = gjk_cache ? gjk_cache->seed(c0, c1) : null;
+		return intersect_colliders(c0, c1, penetration_tolerance, fast_paths, warm, gjk_cache ? &gjk_cache->stats : null);
 	}
 
 	v2f32 velocity_at_point(const Momentum& momentum, v2f32 point) {
@@ -500,60 +1322,727 @@ namespace Physics2D {
 		} };
 	}
 
+	//* takes body ids so the AoS & SoA paths share it, a collider's own body id or a lane of them
+	inline bool distinct_bodies(i32 a, i32 b) {
+		return a != b || a < 0 || b < 0; //* Not the same body or nullbody
+	}
+
 	bool broadphase_test(const Collider& a, const Collider& b, const FlagMatrix<u32>& detections) {
 		return
-			(a.body_id != b.body_id || a.body_id < 0 || b.body_id < 0) && //* Not the same body or nullbody
+			distinct_bodies(a.body_id, b.body_id) &&
 			detections.mask_match(a.layers, b.layers) && //* On colliding layers
 			collide(a.aabb, b.aabb); //* AABBs overlaps
 	}
 
+	//* Collider fields read by the broadphase passes, one array per field
+	//* a Collider is 100+ bytes, streaming its aabb & layers alone out of it wastes most of every cache line
+	//* transforms & shapes stay in the colliders, only the narrowphase reads them & it needs the whole collider anyway
+	struct ColliderLanes {
+		List<f32> min_x;
+		List<f32> min_y;
+		List<f32> max_x;
+		List<f32> max_y;
+		List<u32> layers;
+		List<i32> body_ids;
+
+		static ColliderLanes create(Arena& arena, u32 capacity) {
+			return {
+				.min_x = List{ arena.push_array<f32>(capacity), 0 },
+				.min_y = List{ arena.push_array<f32>(capacity), 0 },
+				.max_x = List{ arena.push_array<f32>(capacity), 0 },
+				.max_y = List{ arena.push_array<f32>(capacity), 0 },
+				.layers = List{ arena.push_array<u32>(capacity), 0 },
+				.body_ids = List{ arena.push_array<i32>(capacity), 0 }
+			};
+		}
+
+		u64 size() const { return layers.current; }
+		rtf32 aabb(u32 i) const { return { v2f32(min_x[i], min_y[i]), v2f32(max_x[i], max_y[i]) }; }
+
+		//* lanes grow together, the caller reserved room in all of them
+		void push(Arena& arena, const Collider& col) {
+			min_x.push_growing(arena, col.aabb.min.x);
+			min_y.push_growing(arena, col.aabb.min.y);
+			max_x.push_growing(arena, col.aabb.max.x);
+			max_y.push_growing(arena, col.aabb.max.y);
+			layers.push_growing(arena, col.layers);
+			body_ids.push_growing(arena, col.body_id);
+		}
+
+		void set_aabb(u32 i, rtf32 aabb) {
+			min_x[i] = aabb.min.x;
+			min_y[i] = aabb.min.y;
+			max_x[i] = aabb.max.x;
+			max_y[i] = aabb.max.y;
+		}
+
+		bool overlap(u32 i, u32 j) const { return min_x[i] <= max_x[j] && min_x[j] <= max_x[i] && min_y[i] <= max_y[j] && min_y[j] <= max_y[i]; }
+	};
+
 	struct SimStep {
+		//* SOA mirrors the broadphase fields of the colliders into lanes, the broadphase passes then stream those instead
+		enum Layout : u32 { AOS, SOA };
+		static constexpr cstrp layouts[] = { "AOS", "SOA" };
+
 		Arena* arena;
 		List<Body> bodies;
 		List<Collider> colliders;
 		List<NarrowTest> tests;
 		f32 dt;
+		Layout layout;
+		ColliderLanes lanes;//* empty with the AOS layout
+
+		static constexpr u32 MIN_GROWTH = 64;
 
-		static SimStep create(Arena* arena, f32 dt, u32 expected_bodies = 1024, u32 expected_colliders_per_bodies = 8) {
-			auto expected_colliders = expected_bodies * expected_colliders_per_bodies;
+		//* tests are sized from what the broadphases actually emit, pass the previous tick's counts to avoid any growth at all
+		static SimStep create(Arena* arena, f32 dt, u32 expected_bodies = 64, u32 expected_colliders = 256, u32 expected_tests = 256, Layout layout = AOS) {
 			return {
 				.arena = arena,
 				.bodies = List{ arena->push_array<Body>(expected_bodies), 0 },
 				.colliders = List{ arena->push_array<Collider>(expected_colliders), 0 },
-				.tests = List{ arena->push_array<NarrowTest>(expected_colliders * (expected_colliders - 1)), 0 },
-				.dt = dt
+				.tests = List{ arena->push_array<NarrowTest>(expected_tests), 0 },
+				.dt = dt,
+				.layout = layout,
+				.lanes = ColliderLanes::create(*arena, layout == SOA ? expected_colliders : 0)
 			};
 		}
 
-		u32 push_body(const Body& body) { return bodies.push_idx(*arena, body); }
-		u32 push_collider(const Collider& col) { return colliders.push_idx(*arena, col); }
-		u32 push_test(NarrowTest test) { return tests.push_idx(*arena, test); }
-
-	};
+		static SimStep create_like(Arena* arena, f32 dt, const SimStep& previous, Layout layout = AOS) {
+			return create(arena, dt,
+				max(MIN_GROWTH, u32(previous.bodies.current)),
+				max(MIN_GROWTH, u32(previous.colliders.current)),
+				max(MIN_GROWTH, u32(previous.tests.current)),
+				layout
+			);
+		}
 
-	Array<NarrowTest> broadphase_naive(SimStep& step, const FlagMatrix<u32>& detections, num_range<u32> range = {}) {
-		PROFILE_SCOPE(__PRETTY_FUNCTION__);
-		if (range.size() == 0)
-			range = { 0, u32(step.colliders.current) };
+		//* geometric growth, keeps pushes amortized O(1) without reserving for the worst case
+		template<typename T> static void reserve_one(Arena& arena, List<T>& list) {
+			if (list.current >= list.capacity.size())
+				list.grow(arena, max<u64>(MIN_GROWTH, list.capacity.size()));
+		}
 
-		auto start = step.tests.current;
-		step.tests.grow(*step.arena, step.colliders.current * (step.colliders.current - 1));
-		for (u32 i = range.min; i < range.max; i++) for (u32 j = i + 1; j < range.max; j++) {
-			if (broadphase_test(step.colliders[i], step.colliders[j], detections))
-				step.push_test({ .ids = { i, j } });
+		u32 push_body(const Body& body) { reserve_one(*arena, bodies); return bodies.push_idx(*arena, body); }
+		u32 push_collider(const Collider& col) {
+			reserve_one(*arena, colliders);
+			auto index = colliders.push_idx(*arena, col);
+			if (colliders[index].world_cloud.size() == 0)
+				colliders[index].world_cloud = world_cloud(*arena, *col.shape, col.transform);
+			if (layout == SOA) {
+				reserve_one(*arena, lanes.min_x);
+				reserve_one(*arena, lanes.min_y);
+				reserve_one(*arena, lanes.max_x);
+				reserve_one(*arena, lanes.max_y);
+				reserve_one(*arena, lanes.layers);
+				reserve_one(*arena, lanes.body_ids);
+				lanes.push(*arena, col);
+			}
+			return index;
+		}
+		u32 push_test(NarrowTest test) { reserve_one(*arena, tests); return tests.push_idx(*arena, test); }
+
+		//* aabb_colliders over a range of the step, keeps the lanes in sync
+		void update_aabbs(num_range<u32> range = {}) {
+			if (range.size() == 0)
+				range = { 0, u32(colliders.current) };
+			aabb_colliders(colliders.used().subspan(range.min, range.size()));
+			if (layout == SOA) for (auto i : iter_ex(range))
+				lanes.set_aabb(i, colliders[i].aabb);
 		}
-		return step.tests.used().subspan(start);
-	}
 
-	Array<Manifold> query_collisions(Arena& arena, Array<const NarrowTest> tests, Array<const Collider> colliders) {
+		//* grows the aabbs of a range of the step by reach_aabb, after update_aabbs & before the broadphases
+		void reach_aabbs(f32 duration, v2f32 acceleration, f32 margin, num_range<u32> range = {}) {
+			if (range.size() == 0)
+				range = { 0, u32(colliders.current) };
+			for (auto i : iter_ex(range)) if (colliders[i].body_id != NILBODY) {
+				auto& body = bodies[colliders[i].body_id];
+				if (body.props.inverse_mass == 0 && body.props.inverse_inertia == 0)//* static, acceleration doesn't apply
+					continue;
+				colliders[i].aabb = reach_aabb(colliders[i].aabb, body, duration, acceleration, margin);
+				if (layout == SOA)
+					lanes.set_aabb(i, colliders[i].aabb);
+			}
+		}
+
+		//* new pose for a collider already in the step, substeps move colliders this way so the pairs the broadphase found keep their indices
+		void move_collider(u32 index, const m3x3f32& transform, v2f32 sweep = v2f32(0)) {
+			auto& col = colliders[index];
+			col.transform = transform;
+			col.sweep = sweep;
+			col.world_cloud = world_cloud(*arena, *col.shape, transform);
+			col.aabb = aabb_collider(col);
+			if (layout == SOA)
+				lanes.set_aabb(index, col.aabb);
+		}
+
+	};
+
+	//* Broadphase passes are written against these, they only ever read aabbs, layers & body ids
+	//* both index the step on every access, colliders pushed during a pass (terrain pieces) may move its storage
+	struct AoSFields {
+		const SimStep& step;
+
+		rtf32 aabb(u32 i) const { return step.colliders[i].aabb; }
+		u32 layers(u32 i) const { return step.colliders[i].layers; }
+		i32 body_id(u32 i) const { return step.colliders[i].body_id; }
+		bool overlap(u32 i, u32 j) const { return collide(step.colliders[i].aabb, step.colliders[j].aabb); }
+	};
+
+	struct SoAFields {
+		const SimStep& step;
+
+		rtf32 aabb(u32 i) const { return step.lanes.aabb(i); }
+		u32 layers(u32 i) const { return step.lanes.layers[i]; }
+		i32 body_id(u32 i) const { return step.lanes.body_ids[i]; }
+		bool overlap(u32 i, u32 j) const { return step.lanes.overlap(i, j); }
+	};
+
+	//* f instantiated for the step's layout
+	template<typename F> auto with_fields(const SimStep& step, const F& f) {
+		return step.layout == SimStep::SOA ? f(SoAFields{ step }) : f(AoSFields{ step });
+	}
+
+	template<typename Fields> bool broadphase_test(const Fields& fields, u32 i, u32 j, const FlagMatrix<u32>& detections) {
+		return
+			distinct_bodies(fields.body_id(i), fields.body_id(j)) &&
+			detections.mask_match(fields.layers(i), fields.layers(j)) && //* On colliding layers
+			fields.overlap(i, j); //* AABBs overlaps
+	}
+
+	Array<NarrowTest> broadphase_naive(SimStep& step, const FlagMatrix<u32>& detections, num_range<u32> range = {}) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		if (range.size() == 0)
+			range = { 0, u32(step.colliders.current) };
+
+		auto [scratch, scope] = scratch_push_scope(0, step.arena); defer{ scratch_pop_scope(scratch, scope); };
+		//* layers gathered once so each collider is filtered against all the following ones in a single batch, the SOA layout has them already
+		auto layers = step.layout == SimStep::SOA ?
+			Array<const u32>(step.lanes.layers.used()).subspan(range.min, range.size()) :
+			Array<const u32>(map(scratch, step.colliders.used().subspan(range.min, range.size()), [](const Collider& col) { return col.layers; }));
+		auto matches = scratch.push_array<u64>((layers.size() + 63) / 64);
+		auto start = step.tests.current;
+		with_fields(step, [&](const auto& fields) {
+			for (u32 i = range.min; i < range.max; i++) {
+				auto following = layers.subspan(i - range.min + 1);
+				detections.match_many(layers[i - range.min], following, matches);
+				for (auto w : u64xrange{ 0, (following.size() + 63) / 64 }) for (auto word = matches[w]; word != 0; word &= word - 1) {
+					auto j = i + 1 + u32(w * 64 + std::countr_zero(word));
+					if (distinct_bodies(fields.body_id(i), fields.body_id(j)) && fields.overlap(i, j))
+						step.push_test({ .ids = { i, j } });
+				}
+			}
+		});
+		return step.tests.used().subspan(start);
+	}
+
+	//* Persistent dynamic tree broadphase, proxies are matched to colliders by their offset in the broadphased range
+	//! colliders must be submitted in the same order every tick for their proxies to be moved instead of reinserted
+	struct TreeBroadphase {
+		AABBTree tree;
+		List<i32> proxies;
+
+		static TreeBroadphase create(Arena* arena, u32 expected_colliders = 256, f32 margin = 0.1f) {
+			return {
+				.tree = AABBTree::create(arena, expected_colliders, margin),
+				.proxies = List{ arena->push_array<i32>(expected_colliders), 0 }
+			};
+		}
+
+		template<typename Fields> void sync(const Fields& fields, num_range<u32> range) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			while (proxies.current > range.size())
+				tree.remove(proxies.pop());
+			for (auto i : u32xrange{ 0, u32(range.size()) }) {
+				if (i < proxies.current)
+					tree.move(proxies[i], fields.aabb(range.min + i));
+				else
+					proxies.push_growing(*tree.arena, tree.insert(fields.aabb(range.min + i), i));
+			}
+		}
+	};
+
+	Array<NarrowTest> broadphase_tree(SimStep& step, TreeBroadphase& broadphase, const FlagMatrix<u32>& detections, num_range<u32> range = {}) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		if (range.size() == 0)
+			range = { 0, u32(step.colliders.current) };
+
+		auto start = step.tests.current;
+		with_fields(step, [&](const auto& fields) {
+			broadphase.sync(fields, range);
+			for (auto i : iter_ex(range)) broadphase.tree.query(fields.aabb(i), [&](u32 item) {
+				auto j = range.min + item;
+				if (j > i && broadphase_test(fields, i, j, detections))
+					step.push_test({ .ids = { i, j } });
+			});
+		});
+		return step.tests.used().subspan(start);
+	}
+
+	//* Persistent sort & sweep broadphase, endpoints stay sorted between ticks so the insertion sort runs close to O(n) on coherent scenes
+	//! same submission order contract as TreeBroadphase
+	struct SAPBroadphase {
+		struct Endpoints {
+			f32 min;
+			f32 max;
+			u32 item;
+		};
+
+		Arena* arena;
+		List<Endpoints> sorted;
+		u32 axis;//* 0 = x, 1 = y
+		u64 swaps;
+
+		static SAPBroadphase create(Arena* arena, u32 expected_colliders = 256, u32 axis = 0) {
+			return {
+				.arena = arena,
+				.sorted = List{ arena->push_array<Endpoints>(expected_colliders), 0 },
+				.axis = axis,
+				.swaps = 0
+			};
+		}
+
+		template<typename Fields> void sync(const Fields& fields, num_range<u32> range) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			//* items are offsets in the range, dropping those past the end keeps the survivors in order
+			u32 kept = 0;
+			for (auto& e : sorted.used()) if (e.item < range.size())
+				sorted[kept++] = e;
+			sorted.current = kept;
+			for (auto item : u32xrange{ kept, u32(range.size()) })
+				sorted.push_growing(*arena, { 0, 0, item });
+
+			for (auto& e : sorted.used()) {
+				auto aabb = fields.aabb(range.min + e.item);
+				e.min = aabb.min[axis];
+				e.max = aabb.max[axis];
+			}
+
+			swaps = 0;
+			for (u64 i = 1; i < sorted.current; i++) {
+				auto e = sorted[i];
+				auto j = i;
+				for (; j > 0 && sorted[j - 1].min > e.min; j--)
+					sorted[j] = sorted[j - 1];
+				swaps += i - j;
+				sorted[j] = e;
+			}
+		}
+	};
+
+	Array<NarrowTest> broadphase_sap(SimStep& step, SAPBroadphase& broadphase, const FlagMatrix<u32>& detections, num_range<u32> range = {}) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		if (range.size() == 0)
+			range = { 0, u32(step.colliders.current) };
+
+		auto start = step.tests.current;
+		with_fields(step, [&](const auto& fields) {
+			broadphase.sync(fields, range);
+			auto sorted = broadphase.sorted.used();
+			for (auto i : u64xrange{ 0, sorted.size() }) for (auto j = i + 1; j < sorted.size() && sorted[j].min <= sorted[i].max; j++) {
+				u32 ids[] = { range.min + sorted[i].item, range.min + sorted[j].item };
+				if (broadphase_test(fields, ids[0], ids[1], detections))
+					step.push_test({ .ids = { min(ids[0], ids[1]), max(ids[0], ids[1]) } });
+			}
+		});
+		return step.tests.used().subspan(start);
+	}
+
+	struct Broadphase {
+		enum Mode : u32 { NAIVE, TREE, SAP } mode;
+		static constexpr cstrp modes[] = { "NAIVE", "TREE", "SAP" };
+		TreeBroadphase tree;
+		SAPBroadphase sap;
+		u64 pairs;
+		num_range<u32> range;//* colliders of the last run, items of the structures are offsets in it
+
+		static Broadphase create(Arena* arena, Mode mode = TREE, u32 expected_colliders = 256) {
+			return {
+				.mode = mode,
+				.tree = TreeBroadphase::create(arena, expected_colliders),
+				.sap = SAPBroadphase::create(arena, expected_colliders),
+				.pairs = 0,
+				.range = { 0, 0 }
+			};
+		}
+
+		//* candidate items for an aabb as of the last run, a superset of the overlapping ones
+		template<typename F> void query(rtf32 aabb, const F& on_item) const {
+			switch (mode) {
+			case NAIVE: for (auto item : u32xrange{ 0, u32(range.size()) }) on_item(item); break;
+			case TREE: tree.tree.query(aabb, on_item); break;
+			case SAP: for (auto& e : sap.sorted.used()) {
+				if (e.min > aabb.max[sap.axis])
+					break;
+				if (e.max >= aabb.min[sap.axis])
+					on_item(e.item);
+			} break;
+			default: panic();
+			}
+		}
+
+		//* candidate items for the segment from origin to origin + displacement
+		template<typename F> void query_ray(v2f32 origin, v2f32 displacement, const F& on_item) const {
+			if (mode == TREE)
+				tree.tree.query_ray(origin, displacement, on_item);
+			else
+				query(rtf32{ glm::min(origin, origin + displacement), glm::max(origin, origin + displacement) }, on_item);
+		}
+
+		Array<NarrowTest> operator()(SimStep& step, const FlagMatrix<u32>& detections, num_range<u32> range = {}) {
+			if (range.size() == 0)
+				range = { 0, u32(step.colliders.current) };
+			this->range = range;
+			auto tests = [&]() -> Array<NarrowTest> {
+				switch (mode) {
+				case NAIVE: return broadphase_naive(step, detections, range);
+				case TREE: return broadphase_tree(step, tree, detections, range);
+				case SAP: return broadphase_sap(step, sap, detections, range);
+				default: panic();
+				}
+			}();
+			pairs = tests.size();
+			return tests;
+		}
+	};
+
+	//* Spatial queries -> raycasts, shape casts, point & aabb overlaps against any number of query sources
+	//* a source enumerates candidate colliders for an aabb or a segment, candidates are filtered by layers then tested exactly,
+	//* casts are time_of_impact from a start pose with the collider held still, a ray is the cast of a single point
+	template<typename S> concept query_source = requires(const S& s, rtf32 aabb, v2f32 v, void(*f)(const Collider&)) {
+		s.overlapping(aabb, f);
+		s.along(v, v, f);
+	};
+
+	struct QueryFilter {
+		u32 layers = ~0u;
+		const FlagMatrix<u32>* matrix = null;//* without one, layers are matched bit to bit
+
+		bool accepts(const Collider& col) const { return matrix ? matrix->mask_match(layers, col.layers) : (layers & col.layers) != 0; }
+	};
+
+	struct Ray {
+		v2f32 origin;
+		v2f32 displacement;//* the ray ends at origin + displacement
+	};
+
+	struct CastHit {
+		const Collider* collider = null;//* null on misses
+		f32 fraction = 1;//* of the displacement
+		v2f32 point = v2f32(0);
+		v2f32 normal = v2f32(0);//* surface normal of the hit collider
+	};
+
+	//* colliders of a SimStep, through the structure of the broadphase that last ran on them or brute force without one
+	struct QueryScene {
+		Array<const Collider> colliders;
+		const Broadphase* broadphase = null;
+
+		template<typename F> void overlapping(rtf32 aabb, const F& on_collider) const {
+			auto test = [&](u32 i) { if (collide(colliders[i].aabb, aabb)) on_collider(colliders[i]); };
+			if (!broadphase) {
+				for (auto i : u32xrange{ 0, u32(colliders.size()) })
+					test(i);
+				return;
+			}
+			broadphase->query(aabb, [&](u32 item) { test(broadphase->range.min + item); });
+		}
+
+		template<typename F> void along(v2f32 origin, v2f32 displacement, const F& on_collider) const {
+			auto test = [&](u32 i) { if (AABBTree::crosses(colliders[i].aabb, origin, displacement)) on_collider(colliders[i]); };
+			if (!broadphase) {
+				for (auto i : u32xrange{ 0, u32(colliders.size()) })
+					test(i);
+				return;
+			}
+			broadphase->query_ray(origin, displacement, [&](u32 item) { test(broadphase->range.min + item); });
+		}
+	};
+
+	constexpr f32 CAST_TOLERANCE = 1e-4f;
+
+	//* fs supports the cast shape at its start pose, start is reported when it already overlaps the target
+	template<support_function F> CastHit cast_against(const Collider& target, const F& fs, v2f32 start, v2f32 displacement) {
+		auto ft = support_function_of(target);
+		auto end = [&](v2f32 direction) -> Segment<v2f32> { auto s = fs(direction); return { s.A + displacement, s.B + displacement }; };
+		auto impact = time_of_impact(ft, end, v2f32(0), displacement, CAST_TOLERANCE);
+		switch (impact.kind) {
+		case Impact::MISSED: return {};
+		case Impact::STARTS_OVERLAPPING: return {
+			.collider = &target,
+			.fraction = 0,
+			.point = start,
+			.normal = glm::length2(displacement) > 0 ? -glm::normalize(displacement) : v2f32(0)
+		};
+		case Impact::HIT: return {
+			.collider = &target,
+			.fraction = impact.time,
+			.point = impact.separation.witnesses[0],
+			.normal = impact.separation.normal
+		};
+		default: panic();
+		}
+	}
+
+	//* rays support a single point, unlike support_function_of(Convex::ORIGIN()) it needs no scratch memory
+	CastHit cast_against(const Collider& target, Ray ray) {
+		return cast_against(target, [&](v2f32) { return Segment<v2f32>{ ray.origin, ray.origin }; }, ray.origin, ray.displacement);
+	}
+
+	bool contains(const Collider& col, v2f32 point) {
+		return separation(support_function_of(col), [&](v2f32) { return Segment<v2f32>{ point, point }; }).distance == 0;
+	}
+
+	//* sources may report a collider several times (terrain pieces spanning several cells), first come is kept
+	template<typename T> Array<T> unique_colliders(Arena& arena, Array<T> found, const Collider* (*key)(const T&)) {
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto seen = PairCache<bool>::create(&scratch, found.size());
+		u64 kept = 0;
+		for (auto& f : found) if (!seen.find(u64(key(f)), 0)) {
+			seen.touch(u64(key(f)), 0);
+			found[kept++] = f;
+		}
+		return found.subspan(0, kept);
+	}
+
+	template<query_source... S> CastHit shape_cast(const Convex& shape, const m3x3f32& transform, v2f32 displacement, QueryFilter filter, const S&... sources) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		auto aabb = aabb_convex(shape, transform);
+		auto swept = aabb | rtf32{ aabb.min + displacement, aabb.max + displacement };
+		CastHit best = {};
+		auto test = [&](const Collider& col) {
+			if (!filter.accepts(col))
+				return;
+			auto hit = cast_against(col, support_function_of(shape, transform), v2f32(transform[2]), displacement);
+			if (hit.collider && (!best.collider || hit.fraction < best.fraction))
+				best = hit;
+		};
+		(sources.overlapping(swept, test), ...);
+		return best;
+	}
+
+	template<query_source... S> CastHit raycast(Ray ray, QueryFilter filter, const S&... sources) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		CastHit best = {};
+		auto test = [&](const Collider& col) {
+			if (!filter.accepts(col))
+				return;
+			auto hit = cast_against(col, ray);
+			if (hit.collider && (!best.collider || hit.fraction < best.fraction))
+				best = hit;
+		};
+		(sources.along(ray.origin, ray.displacement, test), ...);
+		return best;
+	}
+
+	//* every hit along the ray, nearest first
+	template<query_source... S> Array<CastHit> raycast_all(Arena& arena, Ray ray, QueryFilter filter, const S&... sources) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		auto hits = List{ arena.push_array<CastHit>(16), 0 };
+		auto test = [&](const Collider& col) {
+			if (!filter.accepts(col))
+				return;
+			if (auto hit = cast_against(col, ray); hit.collider)
+				hits.push_growing(arena, hit);
+		};
+		(sources.along(ray.origin, ray.displacement, test), ...);
+		auto found = unique_colliders<CastHit>(arena, hits.used(), [](const CastHit& h) { return h.collider; });
+		std::stable_sort(found.begin(), found.end(), [](const CastHit& l, const CastHit& r) { return l.fraction < r.fraction; });
+		return found;
+	}
+
+	//* first hit of each ray, rays are independent so they spread over the pool when given, results don't depend on the thread count
+	//! sources must not touch scratch arenas, colliders must carry their world clouds (SimStep & baked terrain ones do)
+	template<query_source... S> Array<CastHit> raycast_batch(Arena& arena, Array<const Ray> rays, QueryFilter filter, JobPool* jobs, const S&... sources) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		constexpr u32 CHUNK = 32;
+		auto hits = arena.push_array<CastHit>(rays.size());
+		auto run = [&](u32 chunk, u32 worker) {
+			(void)worker;
+			for (auto i : u64xrange{ u64(chunk) * CHUNK, min<u64>(rays.size(), u64(chunk + 1) * CHUNK) })
+				hits[i] = raycast(rays[i], filter, sources...);
+		};
+		auto chunks = u32((rays.size() + CHUNK - 1) / CHUNK);
+		if (jobs)
+			jobs->parallel_for(chunks, run);
+		else for (auto chunk : u32xrange{ 0, chunks })
+			run(chunk, 0);
+		return hits;
+	}
+
+	template<query_source... S> Array<const Collider*> query_point(Arena& arena, v2f32 point, QueryFilter filter, const S&... sources) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		auto found = List{ arena.push_array<const Collider*>(16), 0 };
+		auto test = [&](const Collider& col) {
+			if (filter.accepts(col) && contains(col, point))
+				found.push_growing(arena, &col);
+		};
+		(sources.overlapping(rtf32{ point, point }, test), ...);
+		return unique_colliders<const Collider*>(arena, found.used(), [](const Collider* const& c) { return c; });
+	}
+
+	//* colliders whose aabb overlaps, no exact shape test
+	template<query_source... S> Array<const Collider*> query_aabb(Arena& arena, rtf32 aabb, QueryFilter filter, const S&... sources) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		auto found = List{ arena.push_array<const Collider*>(16), 0 };
+		auto test = [&](const Collider& col) {
+			if (filter.accepts(col) && collide(col.aabb, aabb))
+				found.push_growing(arena, &col);
+		};
+		(sources.overlapping(aabb, test), ...);
+		return unique_colliders<const Collider*>(arena, found.used(), [](const Collider* const& c) { return c; });
+	}
+
+	//* Contacts persisting across ticks, keyed on collider uids, lowest uid first
+	//* a pair whose relative transform stayed within the thresholds since its last query reuses its contact instead of going through the narrowphase
+	struct ContactCache {
+		struct Entry {
+			const Convex* shapes[2];
+			m3x3f32 relative;//* collider 1 in collider 0's space when the contact was last computed
+			bool collided;
+			Contact local;//* contact in collider 0's space
+			f32 normal_impulse;//* accumulated by the solver, warm starts it on the next tick
+			f32 tangent_impulse;
+			u32 age;//* consecutive colliding ticks
+		};
+
+		PairCache<Entry> entries;
+		f32 linear_threshold;//* world units
+		f32 angular_threshold;//* on the world space linear part of the relative transform
+		struct Stats {
+			u64 queries;
+			u64 reused;
+
+			void merge(const Stats& other) {
+				queries += other.queries;
+				reused += other.reused;
+			}
+		} stats;
+
+		static ContactCache create(Arena* arena, u32 expected_pairs = 256, f32 linear_threshold = 1e-4f, f32 angular_threshold = 1e-4f) {
+			return {
+				.entries = PairCache<Entry>::create(arena, expected_pairs),
+				.linear_threshold = linear_threshold,
+				.angular_threshold = angular_threshold,
+				.stats = {}
+			};
+		}
+
+		static Contact transformed(const Contact& ctc, const m3x3f32& transform) {
+			auto point = [&](v2f32 p) -> v2f32 { return transform * v3f32(p, 1); };
+			Contact result = {
+				.penetration = transform * v3f32(ctc.penetration, 0),
+				.supports = {
+					{ point(ctc.supports[0].A), point(ctc.supports[0].B) },
+					{ point(ctc.supports[1].A), point(ctc.supports[1].B) }
+				},
+				.aabb = {}
+			};
+			result.aabb = aabb_segment(result.supports[0]) & aabb_segment(result.supports[1]);
+			return result;
+		}
+
+		static Contact flipped(const Contact& ctc) {
+			return { -ctc.penetration, { ctc.supports[1], ctc.supports[0] }, ctc.aabb };
+		}
+
+		bool coherent(const Entry& entry, const Collider& c0, const Collider& c1, const m3x3f32& relative) const {
+			if (entry.shapes[0] != c0.shape || entry.shapes[1] != c1.shape)
+				return false;
+			//* motion of collider 1 relative to collider 0, measured in world units
+			m3x3f32 drift = c0.transform * (relative - entry.relative);
+			return
+				glm::length(v2f32(drift[2])) <= linear_threshold &&
+				glm::length(v2f32(drift[0])) <= angular_threshold &&
+				glm::length(v2f32(drift[1])) <= angular_threshold;
+		}
+
+		Entry* find(const Collider& c0, const Collider& c1) {
+			if (c0.uid == 0 || c1.uid == 0)
+				return null;
+			return c0.uid < c1.uid ? entries.find(c0.uid, c1.uid) : entries.find(c1.uid, c0.uid);
+		}
+
+		//* creates the entry when missing, only the lookups may insert
+		Entry* entry_of(const Collider& c0, const Collider& c1) {
+			if (c0.uid == 0 || c1.uid == 0)
+				return null;
+			return &(c0.uid < c1.uid ? entries.touch(c0.uid, c1.uid) : entries.touch(c1.uid, c0.uid));
+		}
+
+		//* compute(c0, c1) -> tuple<bool, Contact> runs the narrowphase on cache misses
+		template<typename F> tuple<bool, Contact> query(const Collider& c0, const Collider& c1, const F& compute) {
+			return query(entry_of(c0, c1), c0, c1, compute, stats);
+		}
+
+		//* only writes to the given entry, pairs with different entries can be queried concurrently
+		template<typename F> tuple<bool, Contact> query(Entry* found, const Collider& c0, const Collider& c1, const F& compute, Stats& stats) const {
+			if (!found)
+				return compute(c0, c1);
+			if (c1.uid < c0.uid) {
+				auto [collided, contact] = query(found, c1, c0, compute, stats);
+				return { collided, flipped(contact) };
+			}
+
+			stats.queries++;
+			auto relative = glm::inverse(c0.transform) * c1.transform;
+			auto& entry = *found;
+			if (coherent(entry, c0, c1, relative) && c0.sweep == c1.sweep) {//* swept contacts depend on the sweeps too
+				stats.reused++;
+				if (!entry.collided)
+					return { false, Contact{} };
+				entry.age++;
+				return { true, transformed(entry.local, c0.transform) };
+			}
+
+			auto [collided, contact] = compute(c0, c1);
+			auto persisting = collided && entry.collided;
+			//* field by field, the entry's padding stays as the cache zeroed it
+			entry.shapes[0] = c0.shape;
+			entry.shapes[1] = c1.shape;
+			entry.relative = relative;
+			entry.collided = collided;
+			entry.local = collided ? transformed(contact, glm::inverse(c0.transform)) : Contact{};
+			if (!persisting) {
+				entry.normal_impulse = 0;
+				entry.tangent_impulse = 0;
+			}
+			entry.age = persisting ? entry.age + 1 : 0;
+			return { collided, contact };
+		}
+
+		void next_tick() {
+			entries.next_tick();
+			stats = {};
+		}
+	};
+
+	//* persistent narrowphase state & settings, caches are optional
+	struct NarrowphaseOptions {
+		bool fast_paths = true;
+		GJKCache* gjk = null;
+		ContactCache* contacts = null;
+	};
+
+	Array<Manifold> query_collisions(Arena& arena, Array<const NarrowTest> tests, Array<const Collider> colliders, const NarrowphaseOptions& options = {}) {
 		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		auto gjk_stats = options.gjk ? &options.gjk->stats : null;
 		auto manifolds = List{ arena.push_array<Manifold>(tests.size()), 0 };
 		for (auto& col : tests) {
-			auto [collided, contact] = Physics2D::intersect_convex(
-				support_function_of(*colliders[col.ids[0]].shape, colliders[col.ids[0]].transform),
-				support_function_of(*colliders[col.ids[1]].shape, colliders[col.ids[1]].transform),
-				0.f
-			);
+			auto& c0 = colliders[col.ids[0]];
+			auto& c1 = colliders[col.ids[1]];
+			//* the gjk seed is only looked up when the narrowphase runs, a reused contact keeps it alive instead
+			//* resting contacts can be reused for many ticks, their seed must still be there for the next miss
+			auto computed = false;
+			auto narrowphase = [&](const Collider& a, const Collider& b) {
+				computed = true;
+				auto warm = options.gjk ? options.gjk->seed(c0, c1) : null;
+				return intersect_colliders(a, b, 0.f, options.fast_paths, warm, gjk_stats);
+			};
+			auto [collided, contact] = options.contacts ?
+				options.contacts->query(options.contacts->entry_of(c0, c1), c0, c1, narrowphase, options.contacts->stats) :
+				narrowphase(c0, c1);
+			if (options.gjk && !computed)
+				options.gjk->keep(c0, c1);
 			if (collided) manifolds.push({
 				.src = col,
 				.ctc = contact
@@ -562,6 +2051,76 @@ namespace Physics2D {
 		return manifolds.shrink_to_content(arena);
 	}
 
+	//* same manifolds as query_collisions, bit for bit : tests are split in chunks, each chunk writes its own slice of the output & stats,
+	//* slices are then packed in chunk order, cache entries are all looked up (& created) serially beforehand so workers never insert
+	//! a pair must appear only once in tests, colliders must come from a SimStep (world clouds cached, workers don't touch scratch arenas)
+	Array<Manifold> query_collisions_parallel(Arena& arena, JobPool& jobs, Array<const NarrowTest> tests, Array<const Collider> colliders, const NarrowphaseOptions& options = {}, u32 chunk_size = 128) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		if (jobs.worker_count() == 1 || tests.size() <= chunk_size)
+			return query_collisions(arena, tests, colliders, options);
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+
+		struct Lookup {
+			GJKWarm* warm;
+			ContactCache::Entry* contact;
+		};
+		auto lookups = scratch.push_array<Lookup>(tests.size());
+		//* every seed is touched here, reused contacts included, workers then never need to keep one alive
+		//* a rehash while looking up would leave the earlier lookups pointing into the old slots
+		if (options.gjk) options.gjk->seeds.reserve(tests.size());
+		if (options.contacts) options.contacts->entries.reserve(tests.size());
+		for (auto i : u64xrange{ 0, tests.size() }) {
+			auto& c0 = colliders[tests[i].ids[0]];
+			auto& c1 = colliders[tests[i].ids[1]];
+			if (c0.world_cloud.size() == 0 || c1.world_cloud.size() == 0)
+				return query_collisions(arena, tests, colliders, options);
+			lookups[i] = {
+				.warm = options.gjk ? options.gjk->seed(c0, c1) : null,
+				.contact = options.contacts ? options.contacts->entry_of(c0, c1) : null
+			};
+		}
+
+		struct Chunk {
+			u64 count;
+			GJKCache::Stats gjk;
+			ContactCache::Stats contacts;
+		};
+		auto chunk_count = u32((tests.size() + chunk_size - 1) / chunk_size);
+		auto chunks = scratch.push_array<Chunk>(chunk_count);
+		auto slices = scratch.push_array<Manifold>(tests.size());//* chunk c owns [c * chunk_size, c * chunk_size + chunks[c].count)
+		jobs.parallel_for(chunk_count, [&](u32 c, u32 worker) {
+			(void)worker;
+			auto start = u64(c) * chunk_size;
+			auto end = min<u64>(start + chunk_size, tests.size());
+			Chunk chunk = { 0, {}, {} };
+			auto narrowphase = [&](const Collider& c0, const Collider& c1, GJKWarm* warm) {
+				return intersect_colliders(c0, c1, 0.f, options.fast_paths, warm, &chunk.gjk);
+			};
+			for (auto i : u64xrange{ start, end }) {
+				auto& c0 = colliders[tests[i].ids[0]];
+				auto& c1 = colliders[tests[i].ids[1]];
+				auto warm = lookups[i].warm;
+				auto [collided, contact] = options.contacts ?
+					options.contacts->query(lookups[i].contact, c0, c1, [&](const Collider& a, const Collider& b) { return narrowphase(a, b, warm); }, chunk.contacts) :
+					narrowphase(c0, c1, warm);
+				if (collided)
+					slices[start + chunk.count++] = { .src = tests[i], .ctc = contact };
+			}
+			chunks[c] = chunk;
+		});
+
+		u64 total = 0;
+		for (auto& chunk : chunks)
+			total += chunk.count;
+		auto manifolds = List{ arena.push_array<Manifold>(total), 0 };
+		for (auto c : u32xrange{ 0, chunk_count }) {
+			manifolds.push(slices.subspan(u64(c) * chunk_size, chunks[c].count));
+			if (options.gjk) options.gjk->stats.merge(chunks[c].gjk);
+			if (options.contacts) options.contacts->stats.merge(chunks[c].contacts);
+		}
+		return manifolds.used();
+	}
+
 	struct Delta {
 		Momentum momentum;
 		v2f32 correction;
@@ -606,6 +2165,244 @@ namespace Physics2D {
 		return deltas.shrink_to_content(arena);
 	}
 
+	inline bool is_static(const Body& body) { return body.props.inverse_mass == 0 && body.props.inverse_inertia == 0; }
+
+	//* Sequential impulses -> Erin Catto, Iterative Dynamics with Temporal Coherence (Box2D Lite)
+	//* contacts are solved one after the other against velocities already updated by the previous ones,
+	//* accumulated impulses are clamped (normal >= 0, friction inside its cone) & start from last tick's when a ContactCache is given
+	//* positions are fixed by a few projection passes rather than a velocity bias, so corrections don't feed energy back into the bodies
+	//* with graph colouring, contacts are grouped in colours where no 2 contacts share a dynamic body & solved colour after colour,
+	//* a colour's contacts are independent so they can be spread over a JobPool, the result only depends on the colouring, not the thread count
+	struct SequentialImpulses {
+		static constexpr u32 MAX_COLOURS = 64;//* per body colour masks are u64, contacts that don't fit land in an extra serial batch
+
+		u32 velocity_iterations = 8;
+		u32 position_iterations = 3;
+		bool warm_start = true;
+		f32 correction_factor = 0.8f;//* fraction of the remaining penetration removed per position pass
+		f32 slop = 0.005f;//* penetration left alone so resting contacts stay in contact
+		f32 restitution_threshold = 0.5f;//* approach speed under which contacts don't bounce, resting stacks jitter otherwise
+		bool graph_colouring = true;
+		u32 batch_chunk = 64;//* contacts per job inside a colour
+		struct Colouring {
+			u32 colours;
+			u32 batch_sizes[MAX_COLOURS + 1];//* last one is the serial overflow batch
+		} colouring = {};//* of the last solve
+
+		struct Constraint {
+			i32 bodies[2];
+			v2f32 levers[2];
+			v2f32 normal;//* from body 0 towards body 1
+			v2f32 tangent;
+			f32 normal_mass;
+			f32 tangent_mass;
+			f32 friction;
+			f32 bounce;//* normal velocity targeted by the normal impulse
+			f32 depth;
+			f32 normal_impulse;//* accumulated
+			f32 tangent_impulse;//* accumulated
+			ContactCache::Entry* cached;
+			f32 tangent_sign;//* cache entries are oriented lowest uid first, their tangent flips with the pair
+		};
+
+		//* greedy colouring in manifold order, static bodies never conflict since nothing writes to them
+		Array<Constraint> colour(Arena& arena, Array<const Constraint> constraints, Array<const Body> bodies) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+			auto used = scratch.push_array<u64>(bodies.size());
+			for (auto& mask : used)
+				mask = 0;
+			auto colours = scratch.push_array<u32>(constraints.size());
+			colouring = {};
+			for (auto i : u64xrange{ 0, constraints.size() }) {
+				u64 taken = 0;
+				for (auto b : constraints[i].bodies) if (!is_static(bodies[b]))
+					taken |= used[b];
+				auto c = taken == ~u64(0) ? MAX_COLOURS : u32(std::countr_one(taken));
+				if (c < MAX_COLOURS) for (auto b : constraints[i].bodies) if (!is_static(bodies[b]))
+					used[b] |= u64(1) << c;
+				colours[i] = c;
+				colouring.batch_sizes[c]++;
+				colouring.colours = max(colouring.colours, min(c + 1, MAX_COLOURS));
+			}
+
+			//* counting sort by colour, stable so each batch keeps the manifold order
+			u32 offsets[MAX_COLOURS + 1];
+			for (u32 c = 0, sum = 0; c <= MAX_COLOURS; c++) {
+				offsets[c] = sum;
+				sum += colouring.batch_sizes[c];
+			}
+			auto sorted = arena.push_array<Constraint>(constraints.size());
+			for (auto i : u64xrange{ 0, constraints.size() })
+				sorted[offsets[colours[i]]++] = constraints[i];
+			return sorted;
+		}
+
+		Array<Delta> operator()(Arena& arena, Array<const Body> bodies, Array<const Collider> colliders, Array<const Manifold> manifolds, f32 dt, ContactCache* contacts = null, JobPool* jobs = null) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			(void)dt;
+			using namespace glm;
+			auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+
+			//* linear velocity, angular velocity in radians
+			auto velocities = map(scratch, bodies, [](const Body& body) -> v3f32 { return v3f32(body.momentum.velocity, radians(body.momentum.angular_velocity)); });
+			auto corrections = scratch.push_array<v2f32>(bodies.size());
+			auto touched = scratch.push_array<bool>(bodies.size());
+			for (auto i : u64xrange{ 0, bodies.size() }) {
+				corrections[i] = v2f32(0);
+				touched[i] = false;
+			}
+
+			auto relative_velocity = [&](const Constraint& c) -> v2f32 {
+				auto at = [&](u32 i) { auto v = velocities[c.bodies[i]]; return v2f32(v) + orthogonal_axis(c.levers[i]) * v.z; };
+				return at(1) - at(0);
+			};
+			//* static bodies are never written, a colour may share them across threads
+			auto apply = [&](const Constraint& c, v2f32 impulse) {
+				auto& p0 = bodies[c.bodies[0]].props;
+				auto& p1 = bodies[c.bodies[1]].props;
+				if (!is_static(bodies[c.bodies[0]]))
+					velocities[c.bodies[0]] -= v3f32(impulse * p0.inverse_mass, cross_2(c.levers[0], impulse) * p0.inverse_inertia);
+				if (!is_static(bodies[c.bodies[1]]))
+					velocities[c.bodies[1]] += v3f32(impulse * p1.inverse_mass, cross_2(c.levers[1], impulse) * p1.inverse_inertia);
+			};
+
+			auto constraints = map(scratch, manifolds, [&](const Manifold& manifold) -> Constraint {
+				auto& [src, ctc] = manifold;
+				auto& c0 = colliders[src.ids[0]];
+				auto& c1 = colliders[src.ids[1]];
+				auto& b0 = bodies[c0.body_id];
+				auto& b1 = bodies[c1.body_id];
+				touched[c0.body_id] = touched[c1.body_id] = true;
+
+				auto point = ctc.aabb.center();
+				auto normal = length2(ctc.penetration) > 0 ? normalize(ctc.penetration) : v2f32(0);
+				Constraint c = {
+					.bodies = { c0.body_id, c1.body_id },
+					.levers = { point - b0.center_mass, point - b1.center_mass },
+					.normal = normal,
+					.tangent = orthogonal_axis(normal),
+					.normal_mass = 0,
+					.tangent_mass = 0,
+					.friction = sqrt(b0.props.friction * b1.props.friction),
+					.bounce = 0,
+					.depth = length(ctc.penetration),
+					.normal_impulse = 0,
+					.tangent_impulse = 0,
+					.cached = contacts ? contacts->find(c0, c1) : null,
+					.tangent_sign = c0.uid <= c1.uid ? 1.f : -1.f
+				};
+				auto effective_mass = [&](v2f32 axis) {
+					auto k = b0.props.inverse_mass + b1.props.inverse_mass +
+						pow2(cross_2(c.levers[0], axis)) * b0.props.inverse_inertia +
+						pow2(cross_2(c.levers[1], axis)) * b1.props.inverse_inertia;
+					return k > 0 ? 1.f / k : 0.f;
+				};
+				c.normal_mass = effective_mass(c.normal);
+				c.tangent_mass = effective_mass(c.tangent);
+				auto approach = dot(relative_velocity(c), c.normal);
+				if (approach < -restitution_threshold)
+					c.bounce = -min(b0.props.restitution, b1.props.restitution) * approach;
+				if (warm_start && c.cached) {
+					c.normal_impulse = c.cached->normal_impulse;
+					c.tangent_impulse = c.cached->tangent_impulse * c.tangent_sign;
+				}
+				return c;
+			});
+
+			//* batches of independent constraints, a single serial batch in manifold order without colouring
+			struct Batch { u64 start, size; bool parallel; };
+			Batch batches_buffer[MAX_COLOURS + 1];
+			auto batches = List{ larray(batches_buffer), 0 };
+			if (graph_colouring) {
+				constraints = colour(scratch, constraints, bodies);
+				for (u64 c = 0, start = 0; c <= MAX_COLOURS; start += colouring.batch_sizes[c++]) if (colouring.batch_sizes[c] > 0)
+					batches.push({ start, colouring.batch_sizes[c], c < MAX_COLOURS });
+			} else {
+				colouring = {};
+				batches.push({ 0, constraints.size(), false });
+			}
+			auto for_each_batch = [&](const auto& solve) {
+				for (auto& batch : batches.used()) {
+					auto batch_constraints = constraints.subspan(batch.start, batch.size);
+					if (!jobs || !batch.parallel) {
+						for (auto& c : batch_constraints)
+							solve(c);
+						continue;
+					}
+					auto chunks = u32((batch.size + batch_chunk - 1) / batch_chunk);
+					jobs->parallel_for(chunks, [&](u32 chunk, u32 worker) {
+						(void)worker;
+						for (auto& c : batch_constraints.subspan(u64(chunk) * batch_chunk, min<u64>(batch_chunk, batch.size - u64(chunk) * batch_chunk)))
+							solve(c);
+					});
+				}
+			};
+
+			for_each_batch([&](Constraint& c) { apply(c, c.normal * c.normal_impulse + c.tangent * c.tangent_impulse); });
+
+			for (auto it : u32xrange{ 0, velocity_iterations }) for_each_batch([&](Constraint& c) {
+				(void)it;
+				//* friction first, its cone depends on the current normal impulse
+				auto max_friction = c.friction * c.normal_impulse;
+				auto old_tangent = c.tangent_impulse;
+				c.tangent_impulse = clamp(old_tangent - dot(relative_velocity(c), c.tangent) * c.tangent_mass, -max_friction, +max_friction);
+				apply(c, c.tangent * (c.tangent_impulse - old_tangent));
+
+				auto old_normal = c.normal_impulse;
+				c.normal_impulse = max(0.f, old_normal + (c.bounce - dot(relative_velocity(c), c.normal)) * c.normal_mass);
+				apply(c, c.normal * (c.normal_impulse - old_normal));
+			});
+
+			for (auto it : u32xrange{ 0, position_iterations }) for_each_batch([&](Constraint& c) {
+				(void)it;
+				auto im0 = bodies[c.bodies[0]].props.inverse_mass;
+				auto im1 = bodies[c.bodies[1]].props.inverse_mass;
+				if (im0 + im1 == 0)
+					return;
+				auto remaining = c.depth - dot(corrections[c.bodies[1]] - corrections[c.bodies[0]], c.normal) - slop;
+				if (remaining <= 0)
+					return;
+				auto push = c.normal * (remaining * correction_factor / (im0 + im1));
+				if (im0 > 0)
+					corrections[c.bodies[0]] -= push * im0;
+				if (im1 > 0)
+					corrections[c.bodies[1]] += push * im1;
+			});
+
+			for (auto& c : constraints) if (c.cached) {
+				c.cached->normal_impulse = c.normal_impulse;
+				c.cached->tangent_impulse = c.tangent_impulse * c.tangent_sign;
+			}
+
+			auto deltas = List{ arena.push_array<Delta>(bodies.size()), 0 };
+			for (auto i : u64xrange{ 0, bodies.size() }) if (touched[i]) deltas.push({
+				.momentum = {
+					.velocity = v2f32(velocities[i]) - bodies[i].momentum.velocity,
+					.angular_velocity = degrees(velocities[i].z) - bodies[i].momentum.angular_velocity
+				},
+				.correction = corrections[i],
+				.body_id = i32(i)
+			});
+			return deltas.shrink_to_content(arena);
+		}
+	};
+
+	//* both solvers output Deltas for apply_resolution
+	struct Solver {
+		enum Mode : u32 { AVERAGED, SEQUENTIAL } mode;
+		static constexpr cstrp modes[] = { "AVERAGED", "SEQUENTIAL" };
+		SequentialImpulses sequential;
+
+		Array<Delta> operator()(Arena& arena, Array<const Body> bodies, Array<const Collider> colliders, Array<const Manifold> manifolds, f32 dt, ContactCache* contacts = null, JobPool* jobs = null) {
+			switch (mode) {
+			case AVERAGED: return solve_collisions(arena, bodies, colliders, manifolds, dt);
+			case SEQUENTIAL: return sequential(arena, bodies, colliders, manifolds, dt, contacts, jobs);
+			default: panic();
+			}
+		}
+	};
+
 	Array<const Body> apply_resolution(Array<Body> bodies, Array<const Delta> deltas, u32range body_range = {}) {
 		if (body_range.size() == 0)
 			body_range = { 0, u32(bodies.size()) };
@@ -616,6 +2413,21 @@ namespace Physics2D {
 		return bodies.subspan(body_range.min, body_range.size());
 	}
 
+	//* bit exact fingerprint of the simulated state of bodies, replays & lockstep peers compare these every tick
+	//* properties are inputs so they are left out, +0 & -0 hash differently on purpose
+	u64 state_hash(Array<const Body> bodies, u64 seed = 0) {
+		auto h = seed;
+		auto mix = [&](f32 v) { h = PairCache<bool>::hash(h, std::bit_cast<u32>(v)); };
+		for (auto& body : bodies) {
+			mix(body.center_mass.x);
+			mix(body.center_mass.y);
+			mix(body.momentum.velocity.x);
+			mix(body.momentum.velocity.y);
+			mix(body.momentum.angular_velocity);
+		}
+		return h;
+	}
+
 	Array<const Manifold> filter_physical(Arena& arena, Array<const Body> bodies, Array<const Collider> colliders, Array<const Manifold> manifolds, const FlagMatrix<u32>& flag_matrix) {
 		auto is_physical = [&](const Manifold& manifold){
 			auto& [col, contact] = manifold;
@@ -630,10 +2442,156 @@ namespace Physics2D {
 		return filter(arena, manifolds, [&](auto& m){ return is_physical(m); });
 	}
 
+	//* Contact graph islands -> union-find over the bodies linked by manifolds, returns the root body of every body's island
+	//* static bodies are never linked, the terrain would merge everything into a single island otherwise
+	Array<u32> build_islands(Arena& arena, Array<const Body> bodies, Array<const Collider> colliders, Array<const Manifold> manifolds) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		auto parent = arena.push_array<u32>(bodies.size());
+		for (auto i : u32xrange{ 0, u32(bodies.size()) })
+			parent[i] = i;
+		auto find = [&](u32 i) {
+			while (parent[i] != i)
+				i = parent[i] = parent[parent[i]];//* path halving
+			return i;
+		};
+		for (auto& [src, ctc] : manifolds) {
+			i32 ids[] = { colliders[src.ids[0]].body_id, colliders[src.ids[1]].body_id };
+			if (ids[0] < 0 || ids[1] < 0 || is_static(bodies[ids[0]]) || is_static(bodies[ids[1]]))
+				continue;
+			auto roots = v2u32(find(ids[0]), find(ids[1]));
+			parent[max(roots.x, roots.y)] = min(roots.x, roots.y);//* lowest body index is the root, keeps island ids deterministic
+		}
+		for (auto i : u32xrange{ 0, u32(bodies.size()) })
+			parent[i] = find(i);
+		return parent;
+	}
+
+	//* Persistent per body sleep state, matched to bodies by index
+	//! same submission order contract as the broadphases
+	//* an island falls asleep once all of its bodies stayed under the velocity thresholds for time_to_sleep,
+	//* sleeping bodies aren't integrated, their pairs skip the narrowphase & the solver until an awake body touches the island
+	struct Sleep {
+		struct State {
+			f32 timer;//* seconds spent under the thresholds
+			u32 island;//* root body of the island it fell asleep with
+			bool asleep;
+		};
+
+		Arena* arena;
+		List<State> states;
+		f32 linear_threshold;
+		f32 angular_threshold;//* degrees per second
+		f32 time_to_sleep;
+		bool enabled;
+		struct Stats {
+			u32 islands;
+			u32 sleeping;
+			u64 skipped_tests;
+		} stats;
+
+		static Sleep create(Arena* arena, u32 expected_bodies = 64, f32 linear_threshold = 0.05f, f32 angular_threshold = 2.f, f32 time_to_sleep = 0.5f) {
+			return {
+				.arena = arena,
+				.states = List{ arena->push_array<State>(expected_bodies), 0 },
+				.linear_threshold = linear_threshold,
+				.angular_threshold = angular_threshold,
+				.time_to_sleep = time_to_sleep,
+				.enabled = true,
+				.stats = {}
+			};
+		}
+
+		bool sleeping(u32 body) const { return body < states.current && states[body].asleep; }
+		bool awake_dynamic(Array<const Body> bodies, i32 body) const { return body >= 0 && !is_static(bodies[body]) && !sleeping(body); }
+
+		//* pairs without an awake dynamic body can't produce anything new
+		Array<const NarrowTest> filter_tests(Arena& arena, Array<const NarrowTest> tests, Array<const Body> bodies, Array<const Collider> colliders) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			Array<const NarrowTest> kept = filter(arena, tests, [&](const NarrowTest& test) {
+				return awake_dynamic(bodies, colliders[test.ids[0]].body_id) || awake_dynamic(bodies, colliders[test.ids[1]].body_id);
+			});
+			stats.skipped_tests = tests.size() - kept.size();
+			return kept;
+		}
+
+		void wake(u32 island) {
+			for (auto& state : states.used()) if (state.asleep && state.island == island) {//* field by field, keeps the padding zeroed
+				state.timer = 0;
+				state.asleep = false;
+			}
+		}
+
+		//* an awake dynamic body touching a sleeping one wakes the whole island up, call before solving
+		void wake_touched(Array<const Manifold> manifolds, Array<const Body> bodies, Array<const Collider> colliders) {
+			for (auto& [src, ctc] : manifolds) {
+				i32 ids[] = { colliders[src.ids[0]].body_id, colliders[src.ids[1]].body_id };
+				for (auto i : u32xrange{ 0, 2 }) if (ids[i] >= 0 && sleeping(ids[i]) && awake_dynamic(bodies, ids[1 - i]))
+					wake(states[ids[i]].island);
+			}
+		}
+
+		//* call after the resolution, with the physical manifolds of the tick
+		void update(Array<const Body> bodies, Array<const Collider> colliders, Array<const Manifold> manifolds, f32 dt) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			auto [scratch, scope] = scratch_push_scope(0, arena); defer{ scratch_pop_scope(scratch, scope); };
+			while (states.current < bodies.size()) {
+				states.push_growing(*arena, {});
+				auto& state = states[states.current - 1];
+				memset(&state, 0, sizeof(State));//* padding included, snapshots copy states raw
+				state.island = u32(states.current - 1);
+			}
+
+			auto islands = build_islands(scratch, bodies, colliders, manifolds);
+			auto island_timers = scratch.push_array<f32>(bodies.size());//* lowest timer of the island's bodies, indexed by root
+			for (auto& t : island_timers)
+				t = xf32::max();
+
+			stats.islands = 0;
+			for (auto i : u32xrange{ 0, u32(bodies.size()) }) if (awake_dynamic(bodies, i)) {
+				auto& momentum = bodies[i].momentum;
+				auto resting =
+					glm::length(momentum.velocity) <= linear_threshold &&
+					glm::abs(momentum.angular_velocity) <= angular_threshold;
+				states[i].timer = resting ? states[i].timer + dt : 0;
+				stats.islands += islands[i] == i ? 1 : 0;
+				island_timers[islands[i]] = min(island_timers[islands[i]], states[i].timer);
+			}
+
+			stats.sleeping = 0;
+			for (auto i : u32xrange{ 0, u32(bodies.size()) }) {
+				if (!enabled) {
+					states[i].asleep = false;
+				} else if (awake_dynamic(bodies, i) && island_timers[islands[i]] >= time_to_sleep) {
+					states[i].asleep = true;
+					states[i].island = islands[i];
+				}
+				stats.sleeping += states[i].asleep ? 1 : 0;
+			}
+		}
+	};
+
 	inline u32 step_count(f32 phx_time, f32 real_time, f32 dt, i32range tick_limits) {
 		return u32(glm::clamp(i32((real_time - phx_time) / dt), tick_limits.min, tick_limits.max));
 	}
 
+	//* Sub-stepping -> the broadphase runs once per frame on SimStep::reach_aabbs, the frame's ticks then integrate,
+	//* move their colliders (SimStep::move_collider), run the narrowphase & solve on the pairs it found
+	//* a tick past the first only costs narrowphase & solver, so the cap can sit well above what re-running the whole pipeline affords
+	struct SubStepping {
+		bool enabled = false;
+		i32range ticks = { 0, 5 };//* per frame, when disabled
+		i32range substeps = { 0, 32 };//* per frame, when enabled
+		f32 margin = 0.1f;//* added around reach_aabbs, covers the velocity contacts add within the frame
+
+		u32 count(f32 phx_time, f32 real_time, f32 dt) const { return step_count(phx_time, real_time, dt, enabled ? substeps : ticks); }
+	};
+
+	//* how far real time got past the last tick, render poses lerp from the tick before it to it by this
+	//* draws one tick behind the simulation, in exchange frames that ran 0 or several ticks move as smoothly as the others
+	inline f32 interpolation_alpha(f32 phx_time, f32 real_time, f32 dt) {
+		return glm::clamp((real_time - phx_time) / dt, 0.f, 1.f);
+	}
+
 }
 
 #pragma region Editor
@@ -712,6 +2670,8 @@ bool EditorWidget(const cstr label, Physics2D::Collider& col) {
 		changed |= EditorWidgetPtr("shape", col.shape, [](auto l, auto& e) { return EditorWidget(l, e); });
 		changed |= EditorWidget("body_id", col.body_id);
 		changed |= EditorWidget("layers", col.layers);
+		ImGui::Text("uid : %016llx", col.uid);
+		changed |= EditorWidget("sweep", col.sweep);
 	}
 	return changed;
 }
@@ -742,6 +2702,115 @@ bool EditorWidget(const cstr label, Physics2D::SimStep& step) {
 	return changed;
 }
 
+bool EditorWidget(const cstr label, Physics2D::Broadphase& broadphase) {
+	bool changed = false;
+	if (ImGui::TreeNode(label)) {
+		defer{ ImGui::TreePop(); };
+		i32 m = broadphase.mode;
+		if (ImGui::Combo("mode", &m, Physics2D::Broadphase::modes, array_size(Physics2D::Broadphase::modes))) {
+			broadphase.mode = Physics2D::Broadphase::Mode(m);
+			changed = true;
+		}
+		ImGui::Text("Pairs : %llu", broadphase.pairs);
+		switch (broadphase.mode) {
+		case Physics2D::Broadphase::TREE: ImGui::Text("Tree : %u nodes, height %i", u32(broadphase.tree.tree.nodes.current), broadphase.tree.tree.height()); break;
+		case Physics2D::Broadphase::SAP: {
+			changed |= ImGui::Combo("axis", (i32*)&broadphase.sap.axis, "X\0Y\0");
+			ImGui::Text("Sort swaps : %llu", broadphase.sap.swaps);
+		} break;
+		default: break;
+		}
+	}
+	return changed;
+}
+
+bool EditorWidget(const cstr label, Physics2D::GJKCache& cache) {
+	if (ImGui::TreeNode(label)) {
+		defer{ ImGui::TreePop(); };
+		auto& stats = cache.stats;
+		ImGui::Text("Cached pairs : %llu", cache.seeds.count);
+		ImGui::Text("Queries : %llu, warm hits : %llu", stats.queries, stats.warm_hits);
+		ImGui::Text("Average iterations : %.2f", stats.queries > 0 ? f64(stats.iterations) / f64(stats.queries) : 0.0);
+		f32 histogram[Physics2D::GJKCache::HISTOGRAM_SIZE];
+		for (auto i : u32xrange{ 0, Physics2D::GJKCache::HISTOGRAM_SIZE })
+			histogram[i] = f32(stats.histogram[i]);
+		ImGui::PlotHistogram("iterations", histogram, Physics2D::GJKCache::HISTOGRAM_SIZE, 0, "1 .. 8+", 0, FLT_MAX, ImVec2(0, 60));
+	}
+	return false;
+}
+
+bool EditorWidget(const cstr label, Physics2D::ContactCache& cache) {
+	bool changed = false;
+	if (ImGui::TreeNode(label)) {
+		defer{ ImGui::TreePop(); };
+		changed |= ImGui::DragFloat("linear threshold", &cache.linear_threshold, 1e-5f, 0, 1, "%.5f");
+		changed |= ImGui::DragFloat("angular threshold", &cache.angular_threshold, 1e-5f, 0, 1, "%.5f");
+		ImGui::Text("Cached pairs : %llu", cache.entries.count);
+		ImGui::Text("Queries : %llu, reused : %llu", cache.stats.queries, cache.stats.reused);
+	}
+	return changed;
+}
+
+bool EditorWidget(const cstr label, Physics2D::Solver& solver) {
+	bool changed = false;
+	if (ImGui::TreeNode(label)) {
+		defer{ ImGui::TreePop(); };
+		i32 m = solver.mode;
+		if (ImGui::Combo("mode", &m, Physics2D::Solver::modes, array_size(Physics2D::Solver::modes))) {
+			solver.mode = Physics2D::Solver::Mode(m);
+			changed = true;
+		}
+		if (solver.mode == Physics2D::Solver::SEQUENTIAL) {
+			auto& si = solver.sequential;
+			changed |= ImGui::SliderInt("velocity iterations", (i32*)&si.velocity_iterations, 1, 64);
+			changed |= ImGui::SliderInt("position iterations", (i32*)&si.position_iterations, 0, 16);
+			changed |= ImGui::Checkbox("warm start", &si.warm_start);
+			changed |= EditorWidget("correction factor", si.correction_factor);
+			changed |= EditorWidget("slop", si.slop);
+			changed |= EditorWidget("restitution threshold", si.restitution_threshold);
+			changed |= ImGui::Checkbox("graph colouring", &si.graph_colouring);
+			changed |= ImGui::SliderInt("batch chunk", (i32*)&si.batch_chunk, 1, 1024);
+			if (si.graph_colouring) {
+				ImGui::Text("Colours : %u", si.colouring.colours);
+				for (auto c : u32xrange{ 0, si.colouring.colours })
+					ImGui::Text("  batch %u : %u contacts", c, si.colouring.batch_sizes[c]);
+				if (auto overflow = si.colouring.batch_sizes[Physics2D::SequentialImpulses::MAX_COLOURS])
+					ImGui::Text("  serial overflow : %u contacts", overflow);
+			}
+		}
+	}
+	return changed;
+}
+
+bool EditorWidget(const cstr label, Physics2D::Sleep& sleep) {
+	bool changed = false;
+	if (ImGui::TreeNode(label)) {
+		defer{ ImGui::TreePop(); };
+		changed |= ImGui::Checkbox("enabled", &sleep.enabled);
+		changed |= EditorWidget("linear threshold", sleep.linear_threshold);
+		changed |= EditorWidget("angular threshold", sleep.angular_threshold);
+		changed |= EditorWidget("time to sleep", sleep.time_to_sleep);
+		ImGui::Text("Awake islands : %u, sleeping bodies : %u", sleep.stats.islands, sleep.stats.sleeping);
+		ImGui::Text("Skipped narrow tests : %llu", sleep.stats.skipped_tests);
+	}
+	return changed;
+}
+
+bool EditorWidget(const cstr label, Physics2D::SubStepping& sub) {
+	bool changed = false;
+	if (ImGui::TreeNode(label)) {
+		defer{ ImGui::TreePop(); };
+		changed |= ImGui::Checkbox("enabled", &sub.enabled);
+		if (sub.enabled) {
+			changed |= ImGui::SliderInt("max substeps", &sub.substeps.max, 1, 128);
+			changed |= EditorWidget("reach margin", sub.margin);
+		} else {
+			changed |= ImGui::SliderInt("max ticks", &sub.ticks.max, 1, 16);
+		}
+	}
+	return changed;
+}
+
 #pragma endregion Editor
 
 #pragma region OLD
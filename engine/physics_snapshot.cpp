@@ -0,0 +1,249 @@
+#ifndef GPHYSICS_SNAPSHOT
+# define GPHYSICS_SNAPSHOT
+
+#include <blblstd.hpp>
+#include <cstring>
+#include <stdio.h>
+#include <physics_2d.cpp>
+
+//* Snapshots of the whole simulation state for rollback -> bodies, persistent caches & broadphase structures in a single flat blob
+//* the blob is plain bytes, copy it around freely, restoring it puts every structure back bit for bit so re-simulated ticks hash the same
+//* sections are written & read by the same visit functions, a field added there is saved & restored without touching anything else
+//! process local, contact cache entries keep Convex pointers, the shapes must outlive the snapshots
+//! structures are copied raw, padding included, the structures saved here keep theirs zeroed so equal states give equal blobs
+namespace Physics2D {
+
+	//* the pieces of state to snapshot, the null & empty ones are skipped, restore expects the same pieces as save
+	struct SimState {
+		Array<Body> bodies;//* restored in place, the count must match
+		Array<u8> user = {};//* caller state saved alongside, as raw bytes (rotations, gameplay...), restored in place
+		Broadphase* broadphase = null;
+		GJKCache* gjk = null;
+		ContactCache* contacts = null;
+		Sleep* sleep = null;
+	};
+
+	namespace Snapshot {
+
+		//* sizes the blob before anything is written
+		struct Measure {
+			u64 size = 0;
+
+			template<typename T> void pod(T&) { size += sizeof(T); }
+			template<typename T> void fixed(Array<T> a) { size += sizeof(u64) + a.size_bytes(); }
+			template<typename T> void array(Arena&, Array<T>& a) { fixed(a); }
+			template<typename T> void list(Arena&, List<T>& l) { size += sizeof(u64) + l.used().size_bytes(); }
+		};
+
+		struct Writer {
+			Array<u8> blob;
+			u64 cursor = 0;
+
+			void bytes(const void* src, u64 size) {
+				if (cursor + size > blob.size())
+					(fprintf(stderr, "Physics snapshot doesn't fit its blob, the state grew since it was measured\n"), panic());
+				memcpy(blob.data() + cursor, src, size);
+				cursor += size;
+			}
+			template<typename T> void pod(T& v) { bytes(&v, sizeof(T)); }
+			template<typename T> void fixed(Array<T> a) {
+				u64 count = a.size();
+				pod(count);
+				bytes(a.data(), a.size_bytes());
+			}
+			template<typename T> void array(Arena&, Array<T>& a) { fixed(a); }
+			template<typename T> void list(Arena&, List<T>& l) { fixed(l.used()); }
+		};
+
+		//* storage is reallocated on the structures' own arenas when the snapshot holds more than they have room for
+		struct Reader {
+			Array<const u8> blob;
+			u64 cursor = 0;
+
+			void bytes(void* dst, u64 size) {
+				if (cursor + size > blob.size())
+					(fprintf(stderr, "Physics snapshot is truncated\n"), panic());
+				memcpy(dst, blob.data() + cursor, size);
+				cursor += size;
+			}
+			u64 count() {
+				u64 n;
+				bytes(&n, sizeof(n));
+				return n;
+			}
+			template<typename T> void pod(T& v) { bytes(&v, sizeof(T)); }
+			template<typename T> void fixed(Array<T> a) {
+				if (count() != a.size())
+					(fprintf(stderr, "Physics snapshot doesn't match the state it is restored into\n"), panic());
+				bytes(a.data(), a.size_bytes());
+			}
+			//* shrinks into the live storage when it is big enough, only a bigger array takes new storage from the arena
+			template<typename T> void array(Arena& arena, Array<T>& a) {
+				auto n = count();
+				if (n <= a.size())
+					a = a.subspan(0, n);
+				else
+					a = arena.push_array<T>(n);
+				bytes(a.data(), a.size_bytes());
+			}
+			template<typename T> void list(Arena& arena, List<T>& l) {
+				auto n = count();
+				if (n > l.capacity.size())
+					l = List{ arena.push_array<T>(n), 0 };
+				bytes(l.capacity.data(), n * sizeof(T));
+				l.current = n;
+			}
+		};
+
+		template<typename V, typename T> void visit(V& v, PairCache<T>& cache) {
+			v.array(*cache.arena, cache.slots);
+			v.pod(cache.count);
+			v.pod(cache.tick);
+		}
+
+		template<typename V> void visit(V& v, AABBTree& tree) {
+			v.list(*tree.arena, tree.nodes);
+			v.pod(tree.root);
+			v.pod(tree.free_list);
+			v.pod(tree.margin);
+		}
+
+		template<typename V> void visit(V& v, Broadphase& broadphase) {
+			v.pod(broadphase.mode);
+			visit(v, broadphase.tree.tree);
+			v.list(*broadphase.tree.tree.arena, broadphase.tree.proxies);
+			v.list(*broadphase.sap.arena, broadphase.sap.sorted);
+			v.pod(broadphase.sap.axis);
+			v.pod(broadphase.sap.swaps);
+			v.pod(broadphase.pairs);
+			v.pod(broadphase.range);
+		}
+
+		template<typename V> void visit(V& v, GJKCache& cache) {
+			visit(v, cache.seeds);
+			v.pod(cache.stats);
+		}
+
+		template<typename V> void visit(V& v, ContactCache& cache) {
+			visit(v, cache.entries);
+			v.pod(cache.linear_threshold);
+			v.pod(cache.angular_threshold);
+			v.pod(cache.stats);
+		}
+
+		template<typename V> void visit(V& v, Sleep& sleep) {
+			v.list(*sleep.arena, sleep.states);
+			v.pod(sleep.linear_threshold);
+			v.pod(sleep.angular_threshold);
+			v.pod(sleep.time_to_sleep);
+			v.pod(sleep.enabled);
+			v.pod(sleep.stats);
+		}
+
+		template<typename V> void visit(V& v, SimState& state) {
+			v.fixed(state.bodies);
+			v.fixed(state.user);
+			if (state.broadphase) visit(v, *state.broadphase);
+			if (state.gjk) visit(v, *state.gjk);
+			if (state.contacts) visit(v, *state.contacts);
+			if (state.sleep) visit(v, *state.sleep);
+		}
+
+		u64 size(SimState state) {
+			auto measure = Measure{};
+			visit(measure, state);
+			return measure.size;
+		}
+
+		//* blob must hold at least size(state) bytes, returns the written part of it
+		Array<u8> save(Array<u8> blob, SimState state) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			auto writer = Writer{ blob };
+			visit(writer, state);
+			return blob.subspan(0, writer.cursor);
+		}
+
+		Array<u8> save(Arena& arena, SimState state) { return save(arena.push_array<u8>(size(state)), state); }
+
+		void restore(Array<const u8> blob, SimState state) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			auto reader = Reader{ blob };
+			visit(reader, state);
+			if (reader.cursor != blob.size())
+				(fprintf(stderr, "Physics snapshot doesn't match the state it is restored into\n"), panic());
+		}
+
+		//* Delta against a baseline snapshot -> runs of 8 byte words, alternating unchanged words skipped & changed words copied
+		//* layout : u64 blob size, then { u32 unchanged, u32 changed, changed words... } until the blob is covered
+		//* consecutive ticks mostly differ in body state & a few cache slots, the rest of the blob compresses to a handful of records
+
+		inline u64 word_at(Array<const u8> bytes, u64 i) {
+			u64 w = 0;
+			if (i * 8 < bytes.size())
+				memcpy(&w, bytes.data() + i * 8, min<u64>(8, bytes.size() - i * 8));
+			return w;
+		}
+
+		Array<u8> delta(Arena& arena, Array<const u8> baseline, Array<const u8> blob) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+			auto words = (blob.size() + 7) / 8;
+			//* worst case alternates a changed & an unchanged word, a record every 2 words
+			auto out = scratch.push_array<u8>(sizeof(u64) + words * 8 + (words / 2 + 1) * 2 * sizeof(u32));
+			u64 cursor = 0;
+			auto put = [&](const void* src, u64 size) { memcpy(out.data() + cursor, src, size); cursor += size; };
+			u64 size = blob.size();
+			put(&size, sizeof(size));
+			for (u64 i = 0; i < words;) {
+				u32 run[2] = { 0, 0 };
+				for (; i < words && word_at(blob, i) == word_at(baseline, i); i++)
+					run[0]++;
+				auto changed_start = i;
+				for (; i < words && word_at(blob, i) != word_at(baseline, i); i++)
+					run[1]++;
+				put(run, sizeof(run));
+				for (auto w : u64xrange{ changed_start, i }) {
+					auto word = word_at(blob, w);
+					put(&word, sizeof(word));
+				}
+			}
+			return arena.push_array(Array<const u8>(out.subspan(0, cursor)));
+		}
+
+		Array<u8> apply_delta(Arena& arena, Array<const u8> baseline, Array<const u8> delta) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			u64 cursor = 0;
+			auto get = [&](void* dst, u64 size) {
+				if (cursor + size > delta.size())
+					(fprintf(stderr, "Physics snapshot delta is truncated\n"), panic());
+				memcpy(dst, delta.data() + cursor, size);
+				cursor += size;
+			};
+			u64 size;
+			get(&size, sizeof(size));
+			auto blob = arena.push_array<u8>(size);
+			auto kept = min<u64>(size, baseline.size());
+			memcpy(blob.data(), baseline.data(), kept);
+			memset(blob.data() + kept, 0, size - kept);//* past the baseline's end unchanged words are 0
+			auto words = (size + 7) / 8;
+			for (u64 i = 0; i < words;) {
+				u32 run[2];
+				get(run, sizeof(run));
+				if ((run[0] == 0 && run[1] == 0) || i + run[0] + run[1] > words)
+					(fprintf(stderr, "Physics snapshot delta is corrupt\n"), panic());
+				i += run[0];
+				for (auto w : u64xrange{ i, i + run[1] }) {
+					u64 word;
+					get(&word, sizeof(word));
+					memcpy(blob.data() + w * 8, &word, min<u64>(8, size - w * 8));
+				}
+				i += run[1];
+			}
+			return blob;
+		}
+
+	}
+
+}
+
+#endif
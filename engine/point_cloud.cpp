@@ -0,0 +1,152 @@
+#ifndef GPOINT_CLOUD
+# define GPOINT_CLOUD
+
+#include <blblstd.hpp>
+#include <math.cpp>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//* Structure of arrays point cloud, lets the support search kernels stream each axis
+struct CloudSoA {
+	Array<f32> x;
+	Array<f32> y;
+
+	static CloudSoA create(Arena& arena, u64 count) { return { arena.push_array<f32>(count), arena.push_array<f32>(count) }; }
+
+	u64 size() const { return x.size(); }
+	v2f32 operator[](u64 i) const { return v2f32(x[i], y[i]); }
+	void set(u64 i, v2f32 v) { x[i] = v.x; y[i] = v.y; }
+};
+
+//* candidates are ranked by highest dot product first, then lowest index, so every kernel agrees with the scalar one
+struct SupportCandidate {
+	f32 dot;
+	i64 index;
+
+	static constexpr SupportCandidate none() { return { xf32::lowest(), -1 }; }
+
+	bool before(SupportCandidate other) const {
+		return index >= 0 && (other.index < 0 || dot > other.dot || (dot == other.dot && index < other.index));
+	}
+};
+
+inline void rank_candidate(SupportCandidate c, SupportCandidate& best, SupportCandidate& second) {
+	if (c.before(best)) {
+		second = best;
+		best = c;
+	} else if (c.before(second)) {
+		second = c;
+	}
+}
+
+inline void top_two_scalar(const CloudSoA& cloud, v2f32 dir, u64 start, SupportCandidate& best, SupportCandidate& second) {
+	for (auto i : u64xrange{ start, cloud.size() })
+		rank_candidate({ cloud.x[i] * dir.x + cloud.y[i] * dir.y, i64(i) }, best, second);
+}
+
+//* Per lane best & second best, lanes are merged once at the end, indices are tracked as floats (exact up to 2^24 points)
+//* returns the number of points processed, the remainder is left to the scalar kernel
+
+#if defined(__AVX__)
+
+inline u64 top_two_simd(const CloudSoA& cloud, v2f32 dir, SupportCandidate& best, SupportCandidate& second) {
+	constexpr u64 W = 8;
+	auto n = cloud.size() / W * W;
+	if (n == 0)
+		return 0;
+	auto dx = _mm256_set1_ps(dir.x);
+	auto dy = _mm256_set1_ps(dir.y);
+	auto best_d = _mm256_set1_ps(xf32::lowest());
+	auto best_i = _mm256_set1_ps(-1);
+	auto second_d = best_d;
+	auto second_i = best_i;
+	auto idx = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+	auto stride = _mm256_set1_ps(f32(W));
+	for (u64 i = 0; i < n; i += W) {
+		auto d = _mm256_add_ps(
+			_mm256_mul_ps(_mm256_loadu_ps(cloud.x.data() + i), dx),
+			_mm256_mul_ps(_mm256_loadu_ps(cloud.y.data() + i), dy)
+		);
+		auto gt_best = _mm256_cmp_ps(d, best_d, _CMP_GT_OQ);
+		auto gt_second = _mm256_cmp_ps(d, second_d, _CMP_GT_OQ);
+		second_d = _mm256_blendv_ps(_mm256_blendv_ps(second_d, d, gt_second), best_d, gt_best);
+		second_i = _mm256_blendv_ps(_mm256_blendv_ps(second_i, idx, gt_second), best_i, gt_best);
+		best_d = _mm256_blendv_ps(best_d, d, gt_best);
+		best_i = _mm256_blendv_ps(best_i, idx, gt_best);
+		idx = _mm256_add_ps(idx, stride);
+	}
+	alignas(32) f32 lanes[4][W];
+	_mm256_store_ps(lanes[0], best_d);
+	_mm256_store_ps(lanes[1], best_i);
+	_mm256_store_ps(lanes[2], second_d);
+	_mm256_store_ps(lanes[3], second_i);
+	for (auto l : u64xrange{ 0, W }) {
+		rank_candidate({ lanes[0][l], i64(lanes[1][l]) }, best, second);
+		rank_candidate({ lanes[2][l], i64(lanes[3][l]) }, best, second);
+	}
+	return n;
+}
+
+#elif defined(__SSE2__)
+
+inline u64 top_two_simd(const CloudSoA& cloud, v2f32 dir, SupportCandidate& best, SupportCandidate& second) {
+	constexpr u64 W = 4;
+	auto n = cloud.size() / W * W;
+	if (n == 0)
+		return 0;
+	auto select = [](__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+	auto dx = _mm_set1_ps(dir.x);
+	auto dy = _mm_set1_ps(dir.y);
+	auto best_d = _mm_set1_ps(xf32::lowest());
+	auto best_i = _mm_set1_ps(-1);
+	auto second_d = best_d;
+	auto second_i = best_i;
+	auto idx = _mm_setr_ps(0, 1, 2, 3);
+	auto stride = _mm_set1_ps(f32(W));
+	for (u64 i = 0; i < n; i += W) {
+		auto d = _mm_add_ps(
+			_mm_mul_ps(_mm_loadu_ps(cloud.x.data() + i), dx),
+			_mm_mul_ps(_mm_loadu_ps(cloud.y.data() + i), dy)
+		);
+		auto gt_best = _mm_cmpgt_ps(d, best_d);
+		auto gt_second = _mm_cmpgt_ps(d, second_d);
+		second_d = select(gt_best, best_d, select(gt_second, d, second_d));
+		second_i = select(gt_best, best_i, select(gt_second, idx, second_i));
+		best_d = select(gt_best, d, best_d);
+		best_i = select(gt_best, idx, best_i);
+		idx = _mm_add_ps(idx, stride);
+	}
+	alignas(16) f32 lanes[4][W];
+	_mm_store_ps(lanes[0], best_d);
+	_mm_store_ps(lanes[1], best_i);
+	_mm_store_ps(lanes[2], second_d);
+	_mm_store_ps(lanes[3], second_i);
+	for (auto l : u64xrange{ 0, W }) {
+		rank_candidate({ lanes[0][l], i64(lanes[1][l]) }, best, second);
+		rank_candidate({ lanes[2][l], i64(lanes[3][l]) }, best, second);
+	}
+	return n;
+}
+
+#else
+
+inline u64 top_two_simd(const CloudSoA&, v2f32, SupportCandidate&, SupportCandidate&) { return 0; }
+
+#endif
+
+//* indices of the 2 points furthest along dir, second is the same as the first when there is a single point, both -1 when empty
+inline tuple<i64, i64> support_top_two(const CloudSoA& cloud, v2f32 dir) {
+	auto best = SupportCandidate::none();
+	auto second = SupportCandidate::none();
+	auto processed = top_two_simd(cloud, dir, best, second);
+	top_two_scalar(cloud, dir, processed, best, second);
+	if (best.index < 0)
+		return { -1, -1 };
+	return { best.index, second.index < 0 ? best.index : second.index };
+}
+
+#endif
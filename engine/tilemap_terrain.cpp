@@ -0,0 +1,551 @@
+#ifndef GTILEMAP_TERRAIN
+# define GTILEMAP_TERRAIN
+
+//* Tilemap loading & terrain physics, split from tilemap.cpp so headless builds don't pull the renderer in
+
+#include <blblstd.hpp>
+#include <math.cpp>
+#include <tmx_module.h>
+#include <algorithm>
+#include <spall/profiling.cpp>
+
+#include <physics_2d.cpp>
+#include <pair_cache.cpp>
+
+namespace Tilemap {
+
+	static tmx_map* load_source(const cstr path) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		printf("Loading tilemap %s\n", path);
+		auto source = tmx_load(path);
+		if (!source)
+			tmx_perror("Tilemap");
+		else
+			source->user_data.pointer = (void*)path;
+		return source;
+	}
+
+	static auto load_proc(const cstr path, auto proc) {
+		auto source = load_source(path); defer{ tmx_map_free(source); };
+		return proc(*source);
+	}
+
+	tmx_property* expect_property(tmx_properties* props, tmx_property_type type, const cstr name) {
+		auto prop = tmx_get_property(props, name);
+		return prop && prop->type == type ? prop : null;
+	}
+
+	template<typename T> struct Array2D {
+		Array<T> data;
+		v2u32 dimensions;
+
+		u64 index(v2u32 coord) const {
+			assert(glm::all(glm::lessThan(coord, dimensions)));
+			return coord.x + coord.y * dimensions.x;
+		}
+
+		T& operator[](v2u64 coord) { return data[index(coord)]; };
+		const T& operator[](v2u64 coord) const { return data[index(coord)]; };
+	};
+
+
+	Array2D<u32> get_layer_tiles(Arena& arena, const tmx_layer& layer, v2u32 dimensions, bool remove_flip_bits = true) {
+		auto content = carray(layer.content.gids, dimensions.x  * dimensions.y);
+		if (remove_flip_bits)
+			content = map(arena, content, [&](auto gid){ return gid & TMX_FLIP_BITS_REMOVAL; });
+		else
+			content = arena.push_array(content);
+		return { .data = content, .dimensions = dimensions };
+	}
+
+	Array<tmx_tile*> get_tiles(const tmx_map& source) { return carray(source.tiles, source.tilecount); }
+
+	//* Physics
+	struct Shape {
+		Physics2D::Convex cvx;
+		m3x3f32 transform;
+	};
+
+	struct TileCollider {
+		Array<const Shape> shapes;
+		m3x3f32 transform;
+	};
+
+	u32 get_layer_collision_layers(const tmx_layer& layer, const cstr name = "CollisionLayers") {
+		auto prop = expect_property(layer.properties, PT_INT, name);
+		if (prop)
+			return prop->value.integer;
+		else
+			return 0;
+	}
+
+	Array<Shape> object_shape(Arena& arena, tmx_object* obj_head) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		auto surface_count = count<tmx_object, &tmx_object::next>(obj_head);
+		auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+		auto cvxs = List{ scratch.push_array<Shape>(surface_count * 2), 0 };
+		for (auto& obj : traverse_by<tmx_object, &tmx_object::next>(obj_head)) {
+			auto push_content_points = [&](Arena& arena, const tmx_object& obj) { return map(arena, carray(obj.content.shape->points, obj.content.shape->points_len), [&](const f64* pt) -> v2f32 { return v2f32(pt[0], pt[1]);}); };
+			m3x3f32 transform = Transform2D{
+				.translation = v2f32(obj.x, obj.y),
+				.scale = v2f32(1),
+				.rotation = f32(obj.rotation)
+			};
+			rtf32 rect = { v2f32(0), v2f32(obj.width, obj.height) };
+			switch (obj.obj_type) {
+			case OT_POLYLINE: {
+				auto points = push_content_points(scratch, obj);
+				for (auto i : u64xrange{ 0, points.size() - 1 })
+					cvxs.push_growing(scratch, { Physics2D::Convex::make(Segment{ points[i], points[i + 1] }, 0), transform });
+			} break;
+			case OT_POLYGON: {
+				auto local_scope = scratch.current;
+				auto concave = push_content_points(scratch, obj);
+				auto [polys, verts] = ear_clip(arena, concave);
+				scratch_pop_scope(scratch, local_scope);
+				for (auto poly : polys)
+					cvxs.push_growing(scratch, { Physics2D::Convex::make(poly, 0), transform });
+			} break;
+			case OT_POINT: { cvxs.push_growing(scratch, { Physics2D::Convex::ORIGIN(), transform }); } break;
+			case OT_SQUARE: { cvxs.push_growing(scratch, { Physics2D::Convex::make(rect, 0), transform }); } break;
+			case OT_ELLIPSE: {
+				cvxs.push_growing(scratch, { Physics2D::Convex::UNIT_CIRCLE(), transform * m3x3f32(Transform2D{
+					.translation = rect.center(),
+					.scale = rect.size() / 2.f,
+					.rotation = 0
+				}) });
+			} break;
+			default: break;
+			}
+		}
+		return arena.push_array(cvxs.used());
+	}
+
+	Array<TileCollider> tile_shapeset(Arena& arena, Array<tmx_tile*> tiles, v2u32 tile_dimensions) {
+		PROFILE_SCOPE(__PRETTY_FUNCTION__);
+		return map(arena, tiles,
+			[&](tmx_tile* tile) -> TileCollider {
+				if (tile)
+					return {
+						.shapes = object_shape(arena, tile->collision),
+						.transform = Transform2D{
+							.translation = v2f32(0),
+							.scale = 1.f / v2f32(tile_dimensions),
+							.rotation = 0
+						}
+					};
+				else
+					return {{}, {}};
+			}
+		);
+	}
+
+	tuple<i32xrange, i32xrange> grid_ranges(rti32 grid) {
+		return {
+			i32xrange{ grid.min.x, grid.max.x },
+			i32xrange{ grid.min.y, grid.max.y }
+		};
+	}
+
+	struct Terrain {
+		//* collider uid domain, key packs layer:8 | y:16 | x:16 | shape:8
+		//* merged pieces span several cells, they use y 0xFFFF & the piece's index in the layer instead
+		static constexpr u16 UID_DOMAIN = 0x7E;
+		static constexpr u64 MERGED_KEY = 0xFFFFull << 24;
+		static constexpr f32 MERGE_EPSILON = 1e-4f;
+
+		struct Collider {
+			Array2D<u32> cells;
+			rtf32 aabb;
+			u32 collision_layers;
+			//* world space pieces baked at load, a cell's pieces are cell_refs[cell_offsets[i], cell_offsets[i + 1])
+			//* merged pieces are referenced by every cell they came from
+			Array<const Physics2D::Collider> baked;
+			Array<const u32> cell_offsets;
+			Array<const u32> cell_refs;
+
+			Array<const u32> cell_pieces(v2u32 coord) const {
+				auto cell = cells.index(coord);
+				return cell_refs.subspan(cell_offsets[cell], cell_offsets[cell + 1] - cell_offsets[cell]);
+			}
+
+			//! world space is y up, cell coordinates are y down
+			v2f32 to_grid(v2f32 world) const { return v2f32(world.x - aabb.min.x, cells.dimensions.y - (world.y - aabb.min.y)); }
+
+			//* cells overlapped by a world space aabb, clamped to the layer
+			rti32 grid_overlap(rtf32 world) const {
+				auto intersection = world & aabb;
+				auto a = to_grid(intersection.min), b = to_grid(intersection.max);
+				return {
+					.min = glm::max(v2i32(glm::floor(glm::min(a, b))), v2i32(0)),
+					.max = glm::min(v2i32(glm::ceil(glm::max(a, b))), v2i32(cells.dimensions)),
+				};
+			}
+		};
+		Array<const Collider> layers;
+		Array<const TileCollider> tiles;
+
+		//* unrotated, unrounded rect filling the whole cell, tile space is [0, 1]² once the tile transform is applied
+		static bool covers_cell(const TileCollider& tile, const Shape& shape) {
+			if (shape.cvx.type != Physics2D::Convex::RECT || shape.cvx.radius != 0)
+				return false;
+			m3x3f32 xform = tile.transform * shape.transform;
+			if (glm::abs(xform[0][1]) > MERGE_EPSILON || glm::abs(xform[1][0]) > MERGE_EPSILON)
+				return false;
+			auto a = v2f32(xform * v3f32(shape.cvx.rect.min, 1));
+			auto b = v2f32(xform * v3f32(shape.cvx.rect.max, 1));
+			return
+				glm::all(glm::lessThan(glm::abs(glm::min(a, b)), v2f32(MERGE_EPSILON))) &&
+				glm::all(glm::lessThan(glm::abs(glm::max(a, b) - v2f32(1)), v2f32(MERGE_EPSILON)));
+		}
+
+		//* transforms, aabbs & world clouds of every solid cell are computed once, ticks only copy them in the SimStep
+		//* colliders are left without a body, the terrain body is only known when they get submitted
+		//* with merge, full cell rects are grown greedily into maximal rectangles (rows first, then down while whole rows fit)
+		//* & collinear overlapping or touching segments are joined into single segments, removing the seams between tiles
+		static void bake_layer(Arena& arena, Collider& layer, u64 layer_index, Array<const TileCollider> tiles, bool merge = true) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+			auto dims = layer.cells.dimensions;
+			auto cell_count = layer.cells.data.size();
+			//* piece uid keys pack layer (8 bits) | y (16) | x (16) | shape (8), y 0xFFFF marks merged pieces, anything wider would alias other pieces in the caches
+			if (layer_index > 0xFF || dims.x > 0xFFFF || dims.y >= 0xFFFF)
+				(fprintf(stderr, "Terrain layer %llu is too large for its collider uids (%ux%u cells)\n", layer_index, dims.x, dims.y), panic());
+			for (auto& tile : tiles) if (tile.shapes.size() > 0x100)
+				(fprintf(stderr, "Terrain tile has %llu shapes, collider uids only fit 256\n", u64(tile.shapes.size())), panic());
+			auto cell_xform = [&](v2u32 coord) -> m3x3f32 {
+				return Transform2D{ .translation = layer.aabb.min + v2f32(coord.x, dims.y - coord.y), .scale = v2f32(1, -1), .rotation = 0 };
+			};
+
+			//* merged pieces own their shape, it gets a stable address once every piece is known
+			struct Piece { Physics2D::Collider col; i64 merged_shape; };
+			struct Ref { u32 cell, piece; };
+			auto pieces = List{ scratch.push_array<Piece>(cell_count), 0 };
+			auto merged_shapes = List{ scratch.push_array<Physics2D::Convex>(64), 0 };
+			auto refs = List{ scratch.push_array<Ref>(cell_count), 0 };
+			auto push_merged = [&](Physics2D::Convex shape) {
+				auto piece = u32(pieces.current);
+				pieces.push_growing(scratch, { {
+					.transform = m3x3f32(1),
+					.aabb = {},
+					.shape = null,
+					.body_id = Physics2D::NILBODY,
+					.layers = layer.collision_layers,
+					.uid = Physics2D::collider_uid(UID_DOMAIN, (layer_index << 40) | MERGED_KEY | piece)
+				}, i64(merged_shapes.current) });
+				merged_shapes.push_growing(scratch, shape);
+				return piece;
+			};
+
+			//* cells whose full rect got merged, that shape is skipped when baking the cell's other shapes
+			auto merged_rect = scratch.push_array<i32>(cell_count);
+			for (auto& m : merged_rect)
+				m = -1;
+			if (merge) {
+				auto full = scratch.push_array<i32>(cell_count);
+				for (auto i : u64xrange{ 0, cell_count }) {
+					full[i] = -1;
+					auto& tile = tiles[layer.cells.data[i]];
+					for (auto s : u64xrange{ 0, tile.shapes.size() }) if (covers_cell(tile, tile.shapes[s])) {
+						full[i] = i32(s);
+						break;
+					}
+				}
+				auto free_cell = [&](u32 x, u32 y) { auto i = layer.cells.index(v2u32(x, y)); return full[i] >= 0 && merged_rect[i] < 0; };
+				for (u32 y = 0; y < dims.y; y++) for (u32 x = 0; x < dims.x; x++) if (free_cell(x, y)) {
+					u32 w = 1, h = 1;
+					while (x + w < dims.x && free_cell(x + w, y))
+						w++;
+					for (; y + h < dims.y; h++) {
+						auto row_free = true;
+						for (auto i : u32xrange{ x, x + w })
+							row_free &= free_cell(i, y + h);
+						if (!row_free)
+							break;
+					}
+					//* cell (x, y) spans [x, x + 1] & [dims.y - y - 1, dims.y - y] once flipped
+					auto piece = push_merged(Physics2D::Convex::make(rtf32{
+						.min = layer.aabb.min + v2f32(x, dims.y - (y + h)),
+						.max = layer.aabb.min + v2f32(x + w, dims.y - y)
+					}, 0));
+					for (auto j : u32xrange{ y, y + h }) for (auto i : u32xrange{ x, x + w }) {
+						auto cell = layer.cells.index(v2u32(i, j));
+						merged_rect[cell] = full[cell];
+						refs.push_growing(scratch, { u32(cell), piece });
+					}
+				}
+			}
+
+			//* segments are collected along their line, keyed on the quantized line so the sort groups collinear ones
+			struct Run { i64 key[3]; f32 start, end; v2f32 dir; f32 offset; u32 cell; };
+			auto runs = List{ scratch.push_array<Run>(64), 0 };
+			for (u32 y = 0; y < dims.y; y++) for (u32 x = 0; x < dims.x; x++) {
+				auto coord = v2u32(x, y);
+				auto cell = layer.cells.index(coord);
+				auto& tile = tiles[layer.cells.data[cell]];
+				auto xform_cell = cell_xform(coord);
+				for (u64 shape_index = 0; shape_index < tile.shapes.size(); shape_index++) {
+					auto& shape = tile.shapes[shape_index];
+					if (i64(shape_index) == merged_rect[cell])
+						continue;
+					auto xform = xform_cell * tile.transform * shape.transform;
+					if (merge && shape.cvx.type == Physics2D::Convex::SEGMENT && shape.cvx.radius == 0) {
+						auto a = v2f32(xform * v3f32(shape.cvx.segment.A, 1));
+						auto b = v2f32(xform * v3f32(shape.cvx.segment.B, 1));
+						auto length = glm::length(b - a);
+						if (length > MERGE_EPSILON) {
+							auto dir = (b - a) / length;
+							if (dir.x < 0 || (dir.x == 0 && dir.y < 0))
+								dir = -dir;
+							auto offset = glm::dot(orthogonal_axis(dir), a);
+							auto quantize = [](f32 v) { return i64(glm::round(v / MERGE_EPSILON)); };
+							auto ta = glm::dot(dir, a), tb = glm::dot(dir, b);
+							runs.push_growing(scratch, {
+								.key = { quantize(dir.x), quantize(dir.y), quantize(offset) },
+								.start = min(ta, tb),
+								.end = max(ta, tb),
+								.dir = dir,
+								.offset = offset,
+								.cell = u32(cell)
+							});
+							continue;
+						}
+					}
+					refs.push_growing(scratch, { u32(cell), u32(pieces.current) });
+					pieces.push_growing(scratch, { {
+						.transform = xform,
+						.aabb = {},
+						.shape = &shape.cvx,
+						.body_id = Physics2D::NILBODY,
+						.layers = layer.collision_layers,
+						.uid = Physics2D::collider_uid(UID_DOMAIN, (layer_index << 40) | (u64(coord.y) << 24) | (u64(coord.x) << 8) | shape_index)
+					}, -1 });
+				}
+			}
+
+			std::sort(runs.used().begin(), runs.used().end(), [](const Run& l, const Run& r) {
+				for (auto i : u64xrange{ 0, 3 }) if (l.key[i] != r.key[i])
+					return l.key[i] < r.key[i];
+				return l.start < r.start;
+			});
+			for (u64 i = 0; i < runs.current;) {
+				auto& first = runs[i];
+				auto piece = u32(pieces.current);
+				auto end = first.end;
+				u64 j = i;
+				for (; j < runs.current && memcmp(runs[j].key, first.key, sizeof(first.key)) == 0 && runs[j].start <= end + MERGE_EPSILON; j++) {
+					end = max(end, runs[j].end);
+					refs.push_growing(scratch, { runs[j].cell, piece });
+				}
+				auto normal = orthogonal_axis(first.dir) * first.offset;
+				push_merged(Physics2D::Convex::make(Segment<v2f32>{ normal + first.dir * first.start, normal + first.dir * end }, 0));
+				i = j;
+			}
+
+			//* counting sort of the refs by cell, pieces of a cell stay in creation order
+			auto offsets = arena.push_array<u32>(cell_count + 1);
+			for (auto& o : offsets)
+				o = 0;
+			for (auto& ref : refs.used())
+				offsets[ref.cell + 1]++;
+			for (auto i : u64xrange{ 0, cell_count })
+				offsets[i + 1] += offsets[i];
+			auto cell_refs = arena.push_array<u32>(refs.current);
+			auto cursors = scratch.push_array(offsets.subspan(0, cell_count));
+			for (auto& ref : refs.used())
+				cell_refs[cursors[ref.cell]++] = ref.piece;
+
+			auto shapes = arena.push_array(merged_shapes.used());
+			layer.baked = map(arena, pieces.used(), [&](const Piece& piece) {
+				auto col = piece.col;
+				if (piece.merged_shape >= 0)
+					col.shape = &shapes[piece.merged_shape];
+				col.world_cloud = Physics2D::world_cloud(arena, *col.shape, col.transform);
+				col.aabb = Physics2D::aabb_collider(col);
+				return col;
+			});
+			layer.cell_offsets = offsets;
+			layer.cell_refs = cell_refs;
+		}
+
+		static Terrain create(Arena& arena, const tmx_map& map, bool merge = true) {
+			PROFILE_SCOPE(__PRETTY_FUNCTION__);
+			auto [scratch, scope] = scratch_push_scope(0, &arena); defer{ scratch_pop_scope(scratch, scope); };
+			auto tile_dimensions = v2u32(map.tile_width, map.tile_height);
+			auto layers = List{ scratch.push_array<Collider>(10), 0 };
+			auto base_aabb = rtf32{ v2f32(0), v2f32(map.width, map.height) };
+			[&](this const auto& recurse, tmx_layer* list, v2f32 offset = v2f32(0)) -> void {
+				for (auto& layer : traverse_by<tmx_layer, &tmx_layer::next>(list)) if (layer.visible) {
+					auto local_offset = v2f32(layer.offsetx, layer.offsety) / v2f32(tile_dimensions);
+					auto global_offset = offset + local_offset;
+					auto parallax = v2f32(layer.parallaxx, layer.parallaxy);
+					switch (layer.type) {
+						case L_GROUP: recurse(layer.content.group_head, global_offset); break;
+						case L_LAYER:{
+							auto flags = get_layer_collision_layers(layer);
+							if (flags == 0) break;
+							if (glm::any(glm::greaterThanEqual(abs(parallax - v2f32(1)), v2f32(0.001f)))) {
+								fprintf(stderr, "Collision layer '%s' cannot have parallax != 1\n", layer.name);
+								break;
+							}
+							layers.push_growing(scratch, {
+								.cells = get_layer_tiles(arena, layer, v2u32(map.width, map.height)),
+								.aabb = { base_aabb.min + global_offset, base_aabb.max + global_offset },
+								.collision_layers = flags
+							});
+						} break;
+						default: break;
+					}
+				}
+			}(map.ly_head);
+			auto tiles = tile_shapeset(arena, get_tiles(map), tile_dimensions);
+			auto baked_layers = arena.push_array(layers.used());
+			for (auto i : u64xrange{ 0, baked_layers.size() })
+				bake_layer(arena, baked_layers[i], i, tiles, merge);
+			return {
+				.layers = baked_layers,
+				.tiles = tiles
+			};
+		}
+	};
+
+	//* baked pieces as a Physics2D spatial query source, merged pieces are reported once per cell they cover
+	struct TerrainQuery {
+		const Terrain& terrain;
+
+		//* merged pieces are referenced by every cell they cover, a query only yields them the first time it reaches them
+		//* single cell pieces can't repeat & skip the check, past CAPACITY merged pieces repeats get through (the queries dedupe their results anyway)
+		//* fixed size & on the stack, queries run concurrently on the same terrain
+		struct Seen {
+			static constexpr u32 CAPACITY = 64;
+			u32 pieces[CAPACITY];
+			u32 count = 0;
+
+			bool first(const Terrain::Collider& layer, u32 piece) {
+				if ((layer.baked[piece].uid & Terrain::MERGED_KEY) != Terrain::MERGED_KEY)
+					return true;
+				for (auto i : u32xrange{ 0, count }) if (pieces[i] == piece)
+					return false;
+				if (count < CAPACITY)
+					pieces[count++] = piece;
+				return true;
+			}
+		};
+
+		template<typename F> void overlapping(rtf32 aabb, const F& on_collider) const {
+			for (auto& layer : terrain.layers) if (collide(aabb, layer.aabb)) {
+				auto seen = Seen{};
+				auto [rx, ry] = grid_ranges(layer.grid_overlap(aabb));
+				for (auto y : ry) for (auto x : rx) for (auto piece : layer.cell_pieces(v2u32(x, y)))
+					if (collide(layer.baked[piece].aabb, aabb) && seen.first(layer, piece))
+						on_collider(layer.baked[piece]);
+			}
+		}
+
+		//* cells are walked in the order the segment crosses them -> Amanatides & Woo, A Fast Voxel Traversal Algorithm for Ray Tracing
+		template<typename F> void along(v2f32 origin, v2f32 displacement, const F& on_collider) const {
+			for (auto& layer : terrain.layers) {
+				auto from = layer.to_grid(origin);
+				auto delta = layer.to_grid(origin + displacement) - from;
+				auto dims = v2f32(layer.cells.dimensions);
+				//* clip to the layer first, slab test in grid space
+				f32 enter = 0, exit = 1;
+				for (auto axis : u32xrange{ 0, 2 }) {
+					if (delta[axis] == 0) {
+						if (from[axis] < 0 || from[axis] > dims[axis])
+							exit = -1;
+						continue;
+					}
+					auto t0 = (0 - from[axis]) / delta[axis];
+					auto t1 = (dims[axis] - from[axis]) / delta[axis];
+					enter = max(enter, min(t0, t1));
+					exit = min(exit, max(t0, t1));
+				}
+				if (enter > exit)
+					continue;
+
+				auto entry = from + delta * enter;
+				auto cell = glm::clamp(v2i32(glm::floor(entry)), v2i32(0), v2i32(layer.cells.dimensions) - 1);
+				auto step = v2i32(glm::sign(delta));
+				v2f32 next, increment;//* t of the next cell boundary on each axis & t between boundaries
+				for (auto axis : u32xrange{ 0, 2 }) {
+					if (delta[axis] == 0) {
+						next[axis] = xf32::max();
+						increment[axis] = xf32::max();
+						continue;
+					}
+					auto boundary = f32(cell[axis] + (step[axis] > 0 ? 1 : 0));
+					next[axis] = (boundary - from[axis]) / delta[axis];
+					increment[axis] = glm::abs(1.f / delta[axis]);
+				}
+				auto seen = Seen{};
+				for (auto visits = layer.cells.dimensions.x + layer.cells.dimensions.y + 2; visits > 0; visits--) {
+					for (auto piece : layer.cell_pieces(v2u32(cell)))
+						if (Physics2D::AABBTree::crosses(layer.baked[piece].aabb, origin, displacement) && seen.first(layer, piece))
+							on_collider(layer.baked[piece]);
+					auto axis = next.x < next.y ? 0 : 1;
+					if (next[axis] > exit)
+						break;
+					cell[axis] += step[axis];
+					if (cell[axis] < 0 || cell[axis] >= i32(layer.cells.dimensions[axis]))
+						break;
+					next[axis] += increment[axis];
+				}
+			}
+		}
+	};
+
+	static constexpr u32 UNSET = ~0u;
+	static constexpr u64 PIECE_CACHE_EXPECTED = 256;//* starting size of terrain_broadphase's per layer cache, grows as needed
+
+	Array<Physics2D::NarrowTest> terrain_broadphase(Physics2D::SimStep& step, const Terrain& terrain, const Physics2D::FlagMatrix<u32>& detections, u32range collider_range = {}) {
+		if (collider_range.size() == 0)
+			collider_range = { 0, u32(step.colliders.current) };
+		auto tests_start = step.tests.current;
+		auto terrain_bd = step.push_body({// TODO get properties from source
+			.center_mass = v2f32(0),
+			.momentum = { .vec = v3f32(0) },
+			.props = {
+				.inverse_mass = 0,
+				.inverse_inertia = 0,
+				.restitution = 0.5f,
+				.friction = 0.5f
+			}
+		});
+		for (const auto& layer : terrain.layers) {
+			auto [scratch, scope] = scratch_push_scope(0, step.arena); defer{ scratch_pop_scope(scratch, scope); };
+			//* step index of every baked piece pulled in this tick & the last collider tested against it,
+			//* merged pieces are referenced by several cells so a collider overlapping a few of them must only be tested once
+			//* baked pieces are copied as is, they already carry their aabb & world cloud
+			//* sparse & only as big as what the colliders overlap, the cost doesn't depend on the layer's area
+			struct PieceCache { u32 step_index = UNSET; u32 last_tested = UNSET; };
+			auto pieces = PairCache<PieceCache>::create(&scratch, PIECE_CACHE_EXPECTED);
+
+			Physics2D::with_fields(step, [&](const auto& fields) {
+				for (auto col_idx : iter_ex(collider_range)) if (
+					fields.layers(col_idx) & layer.collision_layers &&
+					collide(fields.aabb(col_idx), layer.aabb)
+				) { //* for every collider that intersects the tilemap layer
+					auto [rx, ry] = grid_ranges(layer.grid_overlap(fields.aabb(col_idx)));
+					for (auto y : ry) for (auto x : rx) for (auto piece_index : layer.cell_pieces(v2u32(x, y))) { //* every piece of every cell in the overlap
+						auto& piece = pieces.touch(u64(piece_index) + 1, 0);//* 0 first keys mark empty slots
+						if (piece.last_tested == col_idx)
+							continue;
+						piece.last_tested = col_idx;
+						if (piece.step_index == UNSET) {
+							auto baked = layer.baked[piece_index];
+							baked.body_id = i32(terrain_bd);
+							piece.step_index = step.push_collider(baked);
+						}
+						if (Physics2D::broadphase_test(fields, col_idx, piece.step_index, detections))
+							step.push_test({ .ids = { col_idx, piece.step_index } });
+					}
+				}
+			});
+		}
+		return step.tests.used().subspan(tests_start);
+	}
+
+};
+
+#endif
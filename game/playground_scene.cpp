@@ -192,6 +192,7 @@ struct RefactorScene {
 	} cam;
 
 	static constexpr u32 ENTITY_COUNT = 3;
+	static constexpr u16 ENTITY_UID_DOMAIN = 1;//* collider uid domain, key is the entity index
 	struct {
 		Tilemap::Terrain terrain;
 		struct {
@@ -201,6 +202,8 @@ struct RefactorScene {
 			Physics2D::Convex* shape;
 			Physics2D::Momentum momentum;
 			Physics2D::Properties props;
+			bool ccd;//* continuous collision, for fast movers that would tunnel through thin terrain
+			Transform2D last_tick;//* pose before the last physics tick, rendering interpolates from it
 		} entities[ENTITY_COUNT];
 		u32 mesh_index;
 	} test;
@@ -229,7 +232,7 @@ struct RefactorScene {
 
 		printf("Terrain layer count : %llu\n", tm_terrain.layers.size());
 		for (auto& l : tm_terrain.layers) {
-			printf("Terrain layer : %p collision : %u\n", &l, l.collision_layers);
+			printf("Terrain layer : %p collision : %u baked pieces : %llu\n", &l, l.collision_layers, u64(l.baked.size()));
 		}
 
 		auto ui_ppl = UI::Pipeline::create(ctx);
@@ -300,6 +303,7 @@ struct RefactorScene {
 					.shape = &shape,
 					.momentum = {.vec = v3f32(0) },
 					.props = {.vec = v4f32(1, 1, 1, 1) },
+					.ccd = false,
 				},
 				{
 					.space = {
@@ -316,6 +320,7 @@ struct RefactorScene {
 					.shape = &shape,
 					.momentum = {.vec = v3f32(0) },
 					.props = {.vec = v4f32(1, 1, 1, 1) },
+					.ccd = false,
 				},
 				{
 					.space = {
@@ -332,10 +337,13 @@ struct RefactorScene {
 					.shape = &shape,
 					.momentum = {.vec = v3f32(0) },
 					.props = {.vec = v4f32(1, 1, 1, 1) },
+					.ccd = false,
 				}
 			},
 			.mesh_index = mesh_index
 		};
+		for (auto& ent : scene.test.entities)
+			ent.last_tick = ent.space.transform;
 
 		return scene;
 	}
@@ -355,6 +363,7 @@ struct RefactorScene {
 					EditorWidget("space", ent.space);
 					EditorWidget("momentum", ent.momentum);
 					EditorWidget("props", ent.props);
+					ImGui::Checkbox("continuous collision", &ent.ccd);
 					EditorWidget("sprite", ent.sprite);
 					ImGui::ColorEdit4("color", glm::value_ptr(ent.color));
 				}
@@ -383,23 +392,46 @@ struct RefactorScene {
 				Array<Physics2D::Delta> deltas;
 				Physics2D::SimStep step;
 			} last_update;
-		} phx_tests = { Arena::from_vmem(1 << 24, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH | Arena::ALLOW_MOVE_MORPH), 0, 1.f / 60.f, {} };
+		} phx_tests = { Arena::from_vmem(1 << 16, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH | Arena::ALLOW_MOVE_MORPH), 0, 1.f / 60.f, {} };
+		static auto phx_persistent = Arena::from_vmem(1 << 20, Arena::COMMIT_ON_PUSH | Arena::ALLOW_CHAIN_GROWTH | Arena::ALLOW_MOVE_MORPH);
+		static auto broadphase = Physics2D::Broadphase::create(&phx_persistent, Physics2D::Broadphase::SAP, ENTITY_COUNT);//* mostly spread along x, sweep & prune fits best
+		static auto gjk_cache = Physics2D::GJKCache::create(&phx_persistent, ENTITY_COUNT * 4);
+		static auto contact_cache = Physics2D::ContactCache::create(&phx_persistent, ENTITY_COUNT * 4);
+		static auto narrowphase = Physics2D::NarrowphaseOptions{ .fast_paths = true, .gjk = &gjk_cache, .contacts = &contact_cache };
+		static auto solver = Physics2D::Solver{ .mode = Physics2D::Solver::SEQUENTIAL, .sequential = {} };
+		static auto sleep = Physics2D::Sleep::create(&phx_persistent, ENTITY_COUNT + 1);
+		static auto collider_layout = Physics2D::SimStep::AOS;
+		static auto substepping = Physics2D::SubStepping{};
+		static JobPool jobs;
+		if (jobs.worker_count() == 1)
+			jobs.start();
 
 		//* Physics Simulation iterations
-		auto phx_it_this_frame = Physics2D::step_count(phx_tests.time, clock.app_time, phx_tests.target_dt, { 0, 5 });
-		for (auto phx_it : u32xrange{ 0, phx_it_this_frame }) {
+		//* sub-stepping broadphases once for the whole frame, every tick of it reuses those pairs
+		auto phx_it_this_frame = substepping.count(phx_tests.time, clock.app_time, phx_tests.target_dt);
+		auto broadphase_passes = substepping.enabled ? min(phx_it_this_frame, 1u) : phx_it_this_frame;
+		auto ticks_per_pass = substepping.enabled ? phx_it_this_frame : 1u;
+
+		//* returns the ccd sweep, the pose before integrating is kept for render interpolation
+		auto integrate = [&](auto& ent, u32 body_index) {
+			ent.last_tick = ent.space.transform;
+			if (sleep.sleeping(body_index))
+				return v2f32(0);
+			ent.momentum.velocity += v2f32(0, -1) * Physics2D::EARTH_GRAVITY * phx_tests.target_dt * gravity_scale;
+			ent.space.transform.translation += ent.momentum.velocity * phx_tests.target_dt;
+			ent.space.transform.rotation += ent.momentum.angular_velocity * phx_tests.target_dt;
+			return ent.ccd ? ent.momentum.velocity * phx_tests.target_dt : v2f32(0);
+		};
+
+		for (auto phx_it : u32xrange{ 0, broadphase_passes }) {
 			(void)phx_it;
 			phx_tests.arena.reset();
-			auto step = Physics2D::SimStep::create(&phx_tests.arena, phx_tests.target_dt);
-			phx_tests.time += phx_tests.target_dt;
+			auto step = Physics2D::SimStep::create_like(&phx_tests.arena, phx_tests.target_dt, phx_tests.last_update.step, collider_layout);
 
 			auto first_ent_body = step.bodies.current;
-			for (auto& ent : test.entities) {
-				ent.momentum.velocity += v2f32(0, -1) * Physics2D::EARTH_GRAVITY * step.dt * gravity_scale;
-
-				//* integrate
-				ent.space.transform.translation += ent.momentum.velocity * step.dt;
-				ent.space.transform.rotation += ent.momentum.angular_velocity * step.dt;
+			auto first_ent_collider = step.colliders.current;
+			for (u32 ent_index = 0; auto& ent : test.entities) {
+				auto sweep = integrate(ent, u32(step.bodies.current));
 
 				//* submit to simulation
 				auto bd = step.push_body({
@@ -409,35 +441,59 @@ struct RefactorScene {
 				});
 				step.push_collider({
 					.transform = ent.space.transform,
-					.aabb = Physics2D::aabb_convex(*ent.shape, ent.space.transform),
+					.aabb = {},
 					.shape = ent.shape,
 					.body_id = i32(bd),
-					.layers = 1
+					.layers = 1,
+					.uid = Physics2D::collider_uid(ENTITY_UID_DOMAIN, ent_index++),
+					.sweep = sweep
 				});
 			}
+			step.update_aabbs({ u32(first_ent_collider), u32(step.colliders.current) });
+			if (substepping.enabled)
+				step.reach_aabbs(step.dt * f32(ticks_per_pass), v2f32(0, -1) * Physics2D::EARTH_GRAVITY * gravity_scale, substepping.margin, { u32(first_ent_collider), u32(step.colliders.current) });
 
 			//* Broadphase
 			static auto detections = Physics2D::FlagMatrix<u32>::create_fill();
-			Physics2D::broadphase_naive(step, detections);
+			broadphase(step, detections);
 			Tilemap::terrain_broadphase(step, test.terrain, detections);
 
-			//* Processing
-			static auto physical_collisions = Physics2D::FlagMatrix<u32>::create_fill();
-			auto manifolds = Physics2D::query_collisions(phx_tests.arena, step.tests.used(), step.colliders.used());
-			auto physical = Physics2D::filter_physical(phx_tests.arena, step.bodies.used(), step.colliders.used(), manifolds, physical_collisions);
-			auto deltas = Physics2D::solve_collisions(phx_tests.arena, step.bodies.used(), step.colliders.used(), physical, step.dt);
-			auto bodies = Physics2D::apply_resolution(step.bodies.used(), deltas, { u32(first_ent_body) , u32(step.bodies.current) });
+			for (auto tick : u32xrange{ 0, ticks_per_pass }) {
+				phx_tests.time += phx_tests.target_dt;
+				if (tick > 0) for (auto i : u32xrange{ 0, ENTITY_COUNT }) {//* the first tick integrated while submitting
+					auto& ent = test.entities[i];
+					auto sweep = integrate(ent, u32(first_ent_body + i));
+					step.bodies[first_ent_body + i] = {
+						.center_mass = ent.space.transform.translation,
+						.momentum = ent.momentum,
+						.props = ent.props
+					};
+					step.move_collider(u32(first_ent_collider + i), ent.space.transform, sweep);
+				}
 
-			for (auto i : u32xrange{ 0, ENTITY_COUNT }) {
-				test.entities[i].momentum = bodies[i].momentum;
-				test.entities[i].space.transform.translation = bodies[i].center_mass;
-			}
+				//* Processing
+				static auto physical_collisions = Physics2D::FlagMatrix<u32>::create_fill();
+				gjk_cache.next_tick();
+				contact_cache.next_tick();
+				auto awake_tests = sleep.filter_tests(phx_tests.arena, step.tests.used(), step.bodies.used(), step.colliders.used());
+				auto manifolds = Physics2D::query_collisions_parallel(phx_tests.arena, jobs, awake_tests, step.colliders.used(), narrowphase);
+				auto physical = Physics2D::filter_physical(phx_tests.arena, step.bodies.used(), step.colliders.used(), manifolds, physical_collisions);
+				sleep.wake_touched(physical, step.bodies.used(), step.colliders.used());
+				auto deltas = solver(phx_tests.arena, step.bodies.used(), step.colliders.used(), physical, step.dt, &contact_cache, &jobs);
+				auto bodies = Physics2D::apply_resolution(step.bodies.used(), deltas, { u32(first_ent_body) , u32(step.bodies.current) });
+				sleep.update(step.bodies.used(), step.colliders.used(), physical, step.dt);
+
+				for (auto i : u32xrange{ 0, ENTITY_COUNT }) {
+					test.entities[i].momentum = sleep.sleeping(first_ent_body + i) ? Physics2D::Momentum{} : bodies[i].momentum;
+					test.entities[i].space.transform.translation = bodies[i].center_mass;
+				}
 
-			phx_tests.last_update = {
-				.collisions = manifolds,
-				.deltas = deltas,
-				.step = step
-			};
+				phx_tests.last_update = {
+					.collisions = manifolds,
+					.deltas = deltas,
+					.step = step
+				};
+			}
 		}
 
 		Physics2D::Debug::Batch debug_batch;
@@ -454,6 +510,14 @@ struct RefactorScene {
 				ImGui::PushStyleColor(ImGuiCol_::ImGuiCol_Text, it_color);
 				ImGui::Text("Physics Iterations this frame : %u", phx_it_this_frame);
 				ImGui::PopStyleColor();
+				EditorWidget("Broadphase", broadphase);
+				ImGui::Combo("Collider layout", (i32*)&collider_layout, Physics2D::SimStep::layouts, array_size(Physics2D::SimStep::layouts));
+				ImGui::Checkbox("Narrowphase fast paths", &narrowphase.fast_paths);
+				EditorWidget("GJK warm start", gjk_cache);
+				EditorWidget("Contact cache", contact_cache);
+				EditorWidget("Solver", solver);
+				EditorWidget("Sleep", sleep);
+				EditorWidget("Sub-stepping", substepping);
 
 			} ImGui::End();
 
@@ -466,8 +530,9 @@ struct RefactorScene {
 		//* accumulate
 		{//* sprite mesh
 			auto batch = gfx.sm_rd.start_batch(); defer{ gfx.sm_rd.consume_batch(batch); };
+			auto alpha = Physics2D::interpolation_alpha(phx_tests.time, clock.app_time, phx_tests.target_dt);
 			for (auto& ent : test.entities)
-				batch.push_entity(ent.space.transform, ent.color, test.mesh_index, carray(&ent.sprite, 1));
+				batch.push_entity(lerp(ent.last_tick, ent.space.transform, alpha), ent.color, test.mesh_index, carray(&ent.sprite, 1));
 		}
 		// {//* ui
 		// 	auto batch = UI::Batch::start(scratch, 1024, 1024 * 1024, {